@@ -0,0 +1,35 @@
+// checks that the headers can be embedded into a program with more than one translation unit: this file includes the same
+// headers as library.cpp and both are linked together (every function of the headers is inline or a template, so it links)
+//     g++ -std=c++17 -O2 -pthread library.cpp embedCheck.cpp -o embedCheck && ./embedCheck
+// the paths counted with solve here (on one ThreadPool for every field) have to be the ones sawCount of library.cpp counts
+
+#include <iostream>
+
+#define LARGE_BOARDS true // like library.cpp, both translation units have to see the same Cell
+
+#include "include/sawLibrary.h"
+#include "include/solver.h"
+#include "include/backbiteSampler.h"
+#include "include/pathFinder.h"
+
+int main() {
+    struct Count {
+        uint64_t paths = 0;
+        void operator()(PathView) { paths++; }
+        void reduce(Count& other) { paths += other.paths; }
+    };
+    const int sizes[][2] = {{1, 2}, {3, 3}, {4, 4}, {5, 3}, {5, 5}, {4, 7}};
+    ThreadPool pool(2);
+    SolveOptions options;
+    options.pool = &pool;
+    bool ok = true;
+    for (const auto& size : sizes) {
+        Field field(size[0], size[1]);
+        uint64_t paths = solve(field, options, Count()).paths;
+        int64_t libraryPaths = sawCount(size[0], size[1], -1, 2);
+        ok = ok && (int64_t)paths == libraryPaths;
+        std::cout << size[0] << "x" << size[1] << ": " << paths << " paths, library " << libraryPaths << std::endl;
+    }
+    std::cout << (ok ? "ok" : "MISMATCH") << std::endl;
+    return ok ? 0 : 1;
+}
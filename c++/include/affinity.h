@@ -0,0 +1,181 @@
+#pragma once
+
+#ifndef _AFFINITY_H_
+#define _AFFINITY_H_
+
+#include <vector>
+#include <string>
+#include <fstream>
+#include <filesystem>
+#include <algorithm>
+#include <thread>
+#include <cctype>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+// where threads run: the logical cpus of the machine with their core and NUMA node as linux reports them in /sys
+// (so no libnuma is needed), and pinning a thread to one of them
+// memory is placed on the node of the thread that touches it first, so a pinned thread that allocates and fills its
+// own state gets it on its local node without any NUMA specific allocation
+// on other systems every cpu is its own core on node 0 and pinning does nothing
+
+// ----------------------------------------------------------------------------------------------------
+// CpuInfo struct
+// ----------------------------------------------------------------------------------------------------
+
+struct CpuInfo {
+    int cpu;
+    int core; // the lowest cpu of its SMT siblings (the same for all hardware threads of one core)
+    int node; // the NUMA node
+};
+
+// the cpus this process is allowed to run on
+std::vector<CpuInfo> availableCpus();
+// the cpus for numThreads threads in the order they should be used: the nodes take turns so every node gets its share of
+// the threads, and on every node one hardware thread per core comes before the SMT siblings (skipSiblings leaves them out)
+// (if there are more threads than cpus the list starts over)
+std::vector<CpuInfo> workerCpus(int numThreads, bool skipSiblings);
+int numCores(); // the cores of the available cpus (cpus that are SMT siblings count once)
+bool pinCurrentThread(int cpu); // false if it didn't work (or isn't supported)
+int currentCpu(); // -1 if unknown
+int nodeOfCpu(int cpu);
+std::vector<int> parseCpuList(const std::string& list); // the format of /sys, like 0-3,8,10-11
+
+// ----------------------------------------------------------------------------------------------------
+// Implementation
+// ----------------------------------------------------------------------------------------------------
+
+inline std::vector<CpuInfo> availableCpus() {
+    std::vector<CpuInfo> cpus;
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+        for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+            if (!CPU_ISSET(cpu, &set))
+                continue;
+            CpuInfo info = {cpu, cpu, nodeOfCpu(cpu)};
+            std::ifstream siblings("/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/topology/thread_siblings_list");
+            std::string list;
+            if (std::getline(siblings, list) && !parseCpuList(list).empty())
+                info.core = parseCpuList(list).front();
+            cpus.push_back(info);
+        }
+    }
+#endif
+    if (cpus.empty())
+        for (int cpu = 0; cpu < std::max((int)std::thread::hardware_concurrency(), 1); cpu++)
+            cpus.push_back({cpu, cpu, 0});
+    return cpus;
+}
+
+inline std::vector<CpuInfo> workerCpus(int numThreads, bool skipSiblings) {
+    std::vector<CpuInfo> cpus = availableCpus();
+    int maxNode = 0;
+    for (int i = 0; i < cpus.size(); i++)
+        maxNode = std::max(maxNode, cpus[i].node);
+
+    // per node: the first hardware thread of every core, then the second ones and so on
+    std::vector<std::vector<CpuInfo>> nodeCpus(maxNode + 1);
+    for (int round = 0; ; round++) {
+        bool any = false;
+        for (int i = 0; i < cpus.size(); i++) {
+            int sibling = 0; // how many cpus of the same core come before this one
+            for (int j = 0; j < i; j++)
+                sibling += cpus[j].core == cpus[i].core;
+            if (sibling == round) {
+                nodeCpus[cpus[i].node].push_back(cpus[i]);
+                any = true;
+            }
+        }
+        if (!any || skipSiblings)
+            break;
+    }
+
+    std::vector<CpuInfo> order;
+    for (int i = 0; order.size() < cpus.size(); i++) {
+        bool any = false;
+        for (int node = 0; node <= maxNode; node++) {
+            if (i < nodeCpus[node].size()) {
+                order.push_back(nodeCpus[node][i]);
+                any = true;
+            }
+        }
+        if (!any)
+            break;
+    }
+
+    std::vector<CpuInfo> result;
+    for (int thread = 0; thread < numThreads && !order.empty(); thread++)
+        result.push_back(order[thread % order.size()]);
+    return result;
+}
+
+inline int numCores() {
+    std::vector<CpuInfo> cpus = availableCpus();
+    std::vector<int> cores;
+    for (int i = 0; i < cpus.size(); i++)
+        cores.push_back(cpus[i].core);
+    std::sort(cores.begin(), cores.end());
+    return std::unique(cores.begin(), cores.end()) - cores.begin();
+}
+
+inline bool pinCurrentThread(int cpu) {
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    (void)cpu;
+    return false;
+#endif
+}
+
+inline int currentCpu() {
+#if defined(__linux__)
+    return sched_getcpu();
+#else
+    return -1;
+#endif
+}
+
+inline int nodeOfCpu(int cpu) {
+    // the cpu directory has a link to its node
+    std::error_code error;
+    std::filesystem::directory_iterator entries("/sys/devices/system/cpu/cpu" + std::to_string(cpu), error);
+    if (error)
+        return 0;
+    for (const std::filesystem::directory_entry& entry : entries) {
+        std::string name = entry.path().filename().string();
+        if (name.rfind("node", 0) == 0 && name.size() > 4 && std::all_of(name.begin() + 4, name.end(), ::isdigit))
+            return std::stoi(name.substr(4));
+    }
+    return 0;
+}
+
+inline std::vector<int> parseCpuList(const std::string& list) {
+    std::vector<int> cpus;
+    size_t pos = 0;
+    while (pos < list.size()) {
+        size_t end = list.find(',', pos);
+        if (end == std::string::npos)
+            end = list.size();
+        std::string range = list.substr(pos, end - pos);
+        size_t dash = range.find('-');
+        try {
+            int first = std::stoi(range.substr(0, dash));
+            int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+            for (int cpu = first; cpu <= last; cpu++)
+                cpus.push_back(cpu);
+        }
+        catch (...) {}
+        pos = end + 1;
+    }
+    return cpus;
+}
+
+#endif
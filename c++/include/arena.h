@@ -0,0 +1,99 @@
+#pragma once
+
+#ifndef _ARENA_H_
+#define _ARENA_H_
+
+#include <cstdlib>
+#include <stdint.h>
+#include <vector>
+#include <algorithm>
+#include <new>
+
+// a bump allocator for memory that only one thread uses
+// everything is handed out of big blocks and given back all at once (with rewind or release),
+// so there is no malloc and free per object and no contention between threads
+
+// ----------------------------------------------------------------------------------------------------
+// Arena class
+// ----------------------------------------------------------------------------------------------------
+
+class Arena {
+public:
+    struct Mark {
+        size_t block;
+        size_t offset;
+    };
+
+    Arena(size_t blockSize = 1 << 20);
+    Arena(const Arena& arena) = delete; // the memory handed out belongs to this arena so it can't be copied
+    ~Arena();
+
+    size_t blockSize; // the size of newly allocated blocks (bigger allocations get their own block)
+
+    void* allocate(size_t size); // the returned memory is 16 byte aligned
+    Mark mark();
+    void rewind(Mark mark); // gives back everything allocated after the mark (the blocks are kept for reuse)
+    void release(); // frees all the blocks
+
+private:
+    struct Block {
+        uint8_t* data;
+        size_t size;
+    };
+
+    std::vector<Block> blocks;
+    size_t currBlock = 0;
+    size_t offset = 0;
+};
+
+// ----------------------------------------------------------------------------------------------------
+// Implementation
+// ----------------------------------------------------------------------------------------------------
+
+inline Arena::Arena(size_t blockSize) : blockSize(blockSize) {}
+
+inline Arena::~Arena() {
+    release();
+}
+
+inline void* Arena::allocate(size_t size) {
+    size = (size + 15) & ~(size_t)15;
+    while (currBlock < blocks.size()) {
+        if (offset + size <= blocks[currBlock].size) {
+            void* ptr = blocks[currBlock].data + offset;
+            offset += size;
+            return ptr;
+        }
+        currBlock++;
+        offset = 0;
+    }
+
+    Block block;
+    block.size = std::max(blockSize, size);
+    block.data = (uint8_t*)std::malloc(block.size);
+    if (block.data == nullptr)
+        throw std::bad_alloc();
+    blocks.push_back(block);
+    currBlock = blocks.size() - 1;
+    offset = size;
+    return block.data;
+}
+
+inline Arena::Mark Arena::mark() {
+    return Mark{currBlock, offset};
+}
+
+inline void Arena::rewind(Mark mark) {
+    currBlock = mark.block;
+    offset = mark.offset;
+}
+
+inline void Arena::release() {
+    for (int i = 0; i < blocks.size(); i++)
+        std::free(blocks[i].data);
+    blocks.clear();
+    currBlock = 0;
+    offset = 0;
+}
+
+#endif
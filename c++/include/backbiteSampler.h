@@ -0,0 +1,110 @@
+#pragma once
+
+#ifndef _BACKBITE_SAMPLER_H_
+#define _BACKBITE_SAMPLER_H_
+
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <stdint.h>
+
+#include "gridNeighbors.h"
+
+// samples paths that visit every cell of a width x height field (Hamiltonian paths) without enumerating them
+// it's a Markov chain of backbite moves: an end of the path bites a neighbor cell, which splits the path there and
+// reverses the part between the end and the bite, so the cell before the bite becomes the new end
+// picking the end and the direction uniformly (moves off the field or onto the path neighbor do nothing) makes the
+// chain symmetric, so after enough moves every path is equally likely
+// the chain walks undirected paths (a path and its reverse are the same state), so sample gives it in a random direction
+// to draw from the directed paths the search counts
+// every move reverses a part of the path (about a quarter of the cells on average), so a sample cells moves after the last
+// costs O(cells^2): 8x8 gives about 150k samples/s per chain, 64x64 about 200 samples/s per chain after the burn-in
+
+// ----------------------------------------------------------------------------------------------------
+// BackbiteSampler class
+// ----------------------------------------------------------------------------------------------------
+
+class BackbiteSampler {
+public:
+    BackbiteSampler(int width, int height, uint64_t seed); // starts with a zigzag path through all rows
+    ~BackbiteSampler() {}
+
+    int width, height;
+    int cells;
+
+    void step(); // one backbite move
+    void steps(uint64_t count) {
+        for (uint64_t i = 0; i < count; i++)
+            step();
+    }
+
+    const std::vector<uint16_t>& path() const { // the cell indices (y * width + x) in the order they are walked
+        return order;
+    }
+    void sample(uint16_t* result); // writes the path into result (cells cell indices), reversed with probability 1/2
+
+private:
+    std::vector<uint16_t> order;
+    std::vector<uint16_t> index; // index[cell] is the position of cell in order
+    std::vector<int> neighbors; // 4 per cell, -1 if that direction leaves the field
+    std::mt19937_64 rng;
+
+    void reverse(int from, int to); // reverses order[from..to] (inclusive)
+};
+
+// ----------------------------------------------------------------------------------------------------
+// Implementation
+// ----------------------------------------------------------------------------------------------------
+
+inline BackbiteSampler::BackbiteSampler(int width, int height, uint64_t seed) : width(width), height(height), cells(width * height),
+        order(width * height), index(width * height), neighbors(gridNeighbors(width, height)), rng(seed) {
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            int cell = y * width + x;
+            int i = y * width + (y % 2 == 0 ? x : width - x - 1);
+            order[i] = cell;
+            index[cell] = i;
+        }
+    }
+}
+
+inline void BackbiteSampler::step() {
+    uint64_t random = rng();
+    bool front = random & 1;
+    int dir = (random >> 1) & 3;
+
+    int end = front ? order[0] : order[cells - 1];
+    int bitten = neighbors[end * 4 + dir];
+    if (bitten < 0)
+        return;
+    int i = index[bitten];
+    if (front) {
+        if (i == 1)
+            return;
+        reverse(0, i - 1);
+    }
+    else {
+        if (i == cells - 2)
+            return;
+        reverse(i + 1, cells - 1);
+    }
+}
+
+inline void BackbiteSampler::sample(uint16_t* result) {
+    if (rng() & 1)
+        std::reverse_copy(order.begin(), order.end(), result);
+    else
+        std::copy(order.begin(), order.end(), result);
+}
+
+inline void BackbiteSampler::reverse(int from, int to) {
+    while (from < to) {
+        std::swap(order[from], order[to]);
+        index[order[from]] = from;
+        index[order[to]] = to;
+        from++;
+        to--;
+    }
+}
+
+#endif
@@ -6,6 +6,19 @@
 #include <iostream>
 #include <math.h>
 #include <stdint.h>
+#include <cstring>
+#include <algorithm>
+
+// can be defined before including this to count or redirect the allocations of the bitmaps
+#ifndef BITMAP_MALLOC
+#define BITMAP_MALLOC(size) std::malloc(size)
+#endif
+#ifndef BITMAP_FREE
+#define BITMAP_FREE(ptr) std::free(ptr)
+#endif
+
+// the cells are packed into 64 bit words (cell i is bit i % 64 of word i / 64), the bits after the last cell are always 0
+// so the bulk operations (count, find, boolean operations, shifts) work a word at a time
 
 class Bitmap;
 class BitRow;
@@ -47,22 +60,57 @@ public:
 class Bitmap {
 public:
     Bitmap(const Bitmap& bitmap); // this constructor ensures that all the data is copied when passed into a function
+    Bitmap(Bitmap&& bitmap) noexcept; // takes over the data of bitmap without copying
     Bitmap(int width, int height, bool defaultValue = false);
     ~Bitmap();
 
+    Bitmap& operator=(const Bitmap& bitmap); // reuses the own data if the sizes match
+    Bitmap& operator=(Bitmap&& bitmap) noexcept;
+
     int width, height;
 
-    int dataSize;
-    uint8_t* data = nullptr;
+    int numWords;
+    uint64_t* data = nullptr;
 
-    bool get(int x, int y);
+    bool get(int x, int y) const;
     void set(int x, int y, bool value);
+    bool getCell(int cell) const; // cell is y * width + x
+    void setCell(int cell, bool value);
+
+    int count() const; // the number of set cells
+    int findFirst(bool value = true) const; // the first cell that is value, -1 if there is none
+    int findNext(int cell, bool value = true) const; // the first cell after cell that is value, -1 if there is none
+    template<typename Function>
+    void forEachSet(Function function) const; // calls function(cell) for every set cell in order
+    void fill(bool value);
+    void invert();
+    // the boolean operations need a bitmap with the same size
+    Bitmap& operator&=(const Bitmap& bitmap);
+    Bitmap& operator|=(const Bitmap& bitmap);
+    Bitmap& andNot(const Bitmap& bitmap); // clears every cell that is set in bitmap
+    bool operator==(const Bitmap& bitmap) const;
+    bool operator!=(const Bitmap& bitmap) const {
+        return !(*this == bitmap);
+    }
+    // moves every cell dx columns to the right and dy rows down (negative is left and up)
+    // cells that are moved out of the field are dropped and the cells that are moved in are cleared
+    void shift(int dx, int dy);
+
+    size_t rawSize() const; // the number of bytes copyTo writes and copyFrom reads
+    void copyTo(uint8_t* dest) const;
+    void copyFrom(const uint8_t* src);
+    void copyFrom(const Bitmap& bitmap); // copies the data of a bitmap with the same size without reallocating
 #ifdef INCLUDE_STB_IMAGE_WRITE_H // checks if stb_image_write.h was included (this is just to avoid unneccecery headers)
     void outputAsBitmap(const char* filepath);
 #endif
 
     BitRow operator[](int y);
-    friend std::ostream& operator<<(std::ostream& os, Bitmap bitmap);
+    friend std::ostream& operator<<(std::ostream& os, const Bitmap& bitmap);
+
+private:
+    uint64_t lastWordMask() const; // the bits of the last word that are cells
+    void clearRange(int from, int to); // clears the cells [from, to)
+    void checkSize(const Bitmap& bitmap) const;
 };
 
 // ----------------------------------------------------------------------------------------------------
@@ -73,11 +121,11 @@ public:
 // BitPointer
 // --------------------------------------------------
 
-void BitPointer::operator=(bool other) {
+inline void BitPointer::operator=(bool other) {
     owner->set(x, y, other);
 }
 
-BitPointer::operator bool() const {
+inline BitPointer::operator bool() const {
     return owner->get(x, y);
 }
 
@@ -85,7 +133,7 @@ BitPointer::operator bool() const {
 // BitRow
 // --------------------------------------------------
 
-BitPointer BitRow::operator[](int x) {
+inline BitPointer BitRow::operator[](int x) {
     if (x >= owner->width || x < 0)
         throw std::invalid_argument("Index out of range!");
     return BitPointer(x, y, owner);
@@ -95,65 +143,252 @@ BitPointer BitRow::operator[](int x) {
 // Bitmap
 // --------------------------------------------------
 
-Bitmap::Bitmap(const Bitmap& bitmap) : width(bitmap.width), height(bitmap.height), dataSize(bitmap.dataSize) {
+inline Bitmap::Bitmap(const Bitmap& bitmap) : width(bitmap.width), height(bitmap.height), numWords(bitmap.numWords) {
     if (bitmap.data == nullptr)
         return;
     
-    data = (uint8_t*)std::malloc(dataSize);
+    data = (uint64_t*)BITMAP_MALLOC(rawSize());
     if (data == nullptr)
         throw std::bad_alloc();
-    std::copy(bitmap.data, bitmap.data + dataSize, data);
+    std::copy(bitmap.data, bitmap.data + numWords, data);
 }
 
-Bitmap::Bitmap(int width, int height, bool defaultValue) : width(width), height(height) {
-    dataSize = std::ceil(width * height / 8.0);
-    data = (uint8_t*)std::malloc(dataSize);
-    for (int i = 0; i < dataSize; i++) {
-        if (defaultValue)
-            data[i] = 0xFF;
-        else
-            data[i] = 0x00;
+inline Bitmap::Bitmap(Bitmap&& bitmap) noexcept : width(bitmap.width), height(bitmap.height), numWords(bitmap.numWords), data(bitmap.data) {
+    bitmap.data = nullptr;
+}
+
+inline Bitmap::Bitmap(int width, int height, bool defaultValue) : width(width), height(height) {
+    numWords = (width * height + 63) / 64;
+    data = (uint64_t*)BITMAP_MALLOC(rawSize());
+    if (data == nullptr)
+        throw std::bad_alloc();
+    fill(defaultValue);
+}
+
+inline Bitmap::~Bitmap() {
+    if (data != nullptr)
+        BITMAP_FREE(data);
+}
+
+inline Bitmap& Bitmap::operator=(const Bitmap& bitmap) {
+    if (this == &bitmap)
+        return *this;
+    if (data != nullptr && bitmap.data != nullptr && numWords == bitmap.numWords) {
+        width = bitmap.width;
+        height = bitmap.height;
+        std::copy(bitmap.data, bitmap.data + numWords, data);
+        return *this;
     }
+    Bitmap copy(bitmap);
+    return *this = std::move(copy);
 }
 
-Bitmap::~Bitmap() {
+inline Bitmap& Bitmap::operator=(Bitmap&& bitmap) noexcept {
+    if (this == &bitmap)
+        return *this;
     if (data != nullptr)
-        std::free(data);
+        BITMAP_FREE(data);
+    width = bitmap.width;
+    height = bitmap.height;
+    numWords = bitmap.numWords;
+    data = bitmap.data;
+    bitmap.data = nullptr;
+    return *this;
 }
 
-bool Bitmap::get(int x, int y) {
-    int index = (y * width + x) / 8;
-    int byteIndex = y * width + x - index * 8;
-    return (data[index] >> byteIndex) & 1;
+inline bool Bitmap::get(int x, int y) const {
+    return getCell(y * width + x);
 }
 
-void Bitmap::set(int x, int y, bool value) {
-    int index = (y * width + x) / 8;
-    int byteIndex = y * width + x - index * 8;
+inline void Bitmap::set(int x, int y, bool value) {
+    setCell(y * width + x, value);
+}
+
+inline bool Bitmap::getCell(int cell) const {
+    return (data[cell / 64] >> (cell % 64)) & 1;
+}
+
+inline void Bitmap::setCell(int cell, bool value) {
     if (value)
-        data[index] |= 1 << byteIndex;
+        data[cell / 64] |= (uint64_t)1 << (cell % 64);
     else
-        data[index] &= ~(1 << byteIndex);
+        data[cell / 64] &= ~((uint64_t)1 << (cell % 64));
+}
+
+inline int Bitmap::count() const {
+    int sum = 0;
+    for (int i = 0; i < numWords; i++)
+        sum += __builtin_popcountll(data[i]);
+    return sum;
+}
+
+inline int Bitmap::findFirst(bool value) const {
+    return findNext(-1, value);
+}
+
+inline int Bitmap::findNext(int cell, bool value) const {
+    int first = cell + 1;
+    if (first >= width * height)
+        return -1;
+    for (int i = first / 64; i < numWords; i++) {
+        uint64_t word = value ? data[i] : ~data[i];
+        if (i == numWords - 1)
+            word &= lastWordMask();
+        if (i == first / 64)
+            word &= ~(uint64_t)0 << (first % 64);
+        if (word != 0)
+            return i * 64 + __builtin_ctzll(word);
+    }
+    return -1;
+}
+
+template<typename Function>
+void Bitmap::forEachSet(Function function) const {
+    for (int i = 0; i < numWords; i++) {
+        for (uint64_t word = data[i]; word != 0; word &= word - 1)
+            function(i * 64 + __builtin_ctzll(word));
+    }
+}
+
+inline void Bitmap::fill(bool value) {
+    for (int i = 0; i < numWords; i++)
+        data[i] = value ? ~(uint64_t)0 : 0;
+    if (numWords > 0)
+        data[numWords - 1] &= lastWordMask();
+}
+
+inline void Bitmap::invert() {
+    for (int i = 0; i < numWords; i++)
+        data[i] = ~data[i];
+    if (numWords > 0)
+        data[numWords - 1] &= lastWordMask();
+}
+
+inline Bitmap& Bitmap::operator&=(const Bitmap& bitmap) {
+    checkSize(bitmap);
+    for (int i = 0; i < numWords; i++)
+        data[i] &= bitmap.data[i];
+    return *this;
+}
+
+inline Bitmap& Bitmap::operator|=(const Bitmap& bitmap) {
+    checkSize(bitmap);
+    for (int i = 0; i < numWords; i++)
+        data[i] |= bitmap.data[i];
+    return *this;
+}
+
+inline Bitmap& Bitmap::andNot(const Bitmap& bitmap) {
+    checkSize(bitmap);
+    for (int i = 0; i < numWords; i++)
+        data[i] &= ~bitmap.data[i];
+    return *this;
+}
+
+inline bool Bitmap::operator==(const Bitmap& bitmap) const {
+    if (bitmap.width != width || bitmap.height != height)
+        return false;
+    for (int i = 0; i < numWords; i++)
+        if (data[i] != bitmap.data[i])
+            return false;
+    return true;
+}
+
+inline void Bitmap::shift(int dx, int dy) {
+    if (dx >= width || -dx >= width || dy >= height || -dy >= height) {
+        fill(false);
+        return;
+    }
+
+    // a cell moves by dy * width + dx in the cell order, that is a shift of the whole bit string
+    int offset = dy * width + dx;
+    int wordOffset = (offset >= 0 ? offset : -offset) / 64;
+    int bitOffset = (offset >= 0 ? offset : -offset) % 64;
+    if (offset > 0) {
+        for (int i = numWords - 1; i >= 0; i--) {
+            int src = i - wordOffset;
+            uint64_t word = src >= 0 ? data[src] << bitOffset : 0;
+            if (bitOffset != 0 && src - 1 >= 0)
+                word |= data[src - 1] >> (64 - bitOffset);
+            data[i] = word;
+        }
+    }
+    else if (offset < 0) {
+        for (int i = 0; i < numWords; i++) {
+            int src = i + wordOffset;
+            uint64_t word = src < numWords ? data[src] >> bitOffset : 0;
+            if (bitOffset != 0 && src + 1 < numWords)
+                word |= data[src + 1] << (64 - bitOffset);
+            data[i] = word;
+        }
+    }
+    if (numWords > 0)
+        data[numWords - 1] &= lastWordMask();
+
+    // the cells that went over the left or right edge ended up in the row next to them
+    for (int y = 0; y < height && dx != 0; y++) {
+        if (dx > 0)
+            clearRange(y * width, y * width + dx);
+        else
+            clearRange(y * width + width + dx, y * width + width);
+    }
+}
+
+inline size_t Bitmap::rawSize() const {
+    return numWords * sizeof(uint64_t);
+}
+
+inline void Bitmap::copyTo(uint8_t* dest) const {
+    std::memcpy(dest, data, rawSize());
+}
+
+inline void Bitmap::copyFrom(const uint8_t* src) {
+    std::memcpy(data, src, rawSize());
+}
+
+inline void Bitmap::copyFrom(const Bitmap& bitmap) {
+    checkSize(bitmap);
+    std::copy(bitmap.data, bitmap.data + numWords, data);
+}
+
+inline uint64_t Bitmap::lastWordMask() const {
+    int usedBits = width * height % 64;
+    return usedBits == 0 ? ~(uint64_t)0 : ((uint64_t)1 << usedBits) - 1;
+}
+
+inline void Bitmap::clearRange(int from, int to) {
+    while (from < to) {
+        int bits = std::min(64 - from % 64, to - from);
+        uint64_t mask = bits == 64 ? ~(uint64_t)0 : (((uint64_t)1 << bits) - 1) << (from % 64);
+        data[from / 64] &= ~mask;
+        from += bits;
+    }
+}
+
+inline void Bitmap::checkSize(const Bitmap& bitmap) const {
+    if (bitmap.width != width || bitmap.height != height)
+        throw std::invalid_argument("Bitmaps have different sizes!");
 }
 
 #ifdef INCLUDE_STB_IMAGE_WRITE_H
-void Bitmap::outputAsBitmap(const char* filepath) {
+inline void Bitmap::outputAsBitmap(const char* filepath) {
     uint8_t* img = (uint8_t*)std::malloc(width * height);
-    for (int y = 0; y < height; y++)
-        for (int x = 0; x < width; x++)
-            img[y * width + x] = get(x, y) * 255;
+    std::memset(img, 0, width * height);
+    forEachSet([img](int cell) {
+        img[cell] = 255;
+    });
     stbi_write_bmp(filepath, width, height, 1, img);
     std::free(img);
 }
 #endif
 
-BitRow Bitmap::operator[](int y) {
+inline BitRow Bitmap::operator[](int y) {
     if (y >= height || y < 0)
         throw std::invalid_argument("index out of range!");
     return BitRow(y, this);
 }
 
-std::ostream& operator<<(std::ostream& os, Bitmap bitmap) {
+inline std::ostream& operator<<(std::ostream& os, const Bitmap& bitmap) {
     for (int y = 0; y < bitmap.height; y++) {
         for (int x = 0; x < bitmap.width; x++)
             os << (bitmap.get(x, y) ? '#' : '-');
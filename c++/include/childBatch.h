@@ -0,0 +1,152 @@
+#pragma once
+
+#ifndef _CHILD_BATCH_H_
+#define _CHILD_BATCH_H_
+
+#include <vector>
+#include <stdint.h>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+// evaluates all children of a node together on 64 bit boards (one bit per cell, so fields with up to 64 cells)
+// a child is the board with one more cell set, it is connected if a flood fill from its first free cell reaches every free cell
+// the flood fill grows by shifting the whole board in every direction at once instead of visiting cells one by one
+// with AVX2 four children are filled at the same time (one per 64 bit lane), otherwise they are filled one after another
+
+// ----------------------------------------------------------------------------------------------------
+// ChildBatch class
+// ----------------------------------------------------------------------------------------------------
+
+class ChildBatch {
+public:
+    template<typename Delta>
+    ChildBatch(int width, int height, const std::vector<Delta>& directions); // anything with x and y works as a direction
+    ~ChildBatch() {}
+
+    int width, height;
+    int cells;
+    bool usable; // only fields with up to 64 cells fit into a board
+    uint64_t full = 0; // every cell of the field
+
+    static uint64_t bit(int cell) {
+        return cell < 64 ? (uint64_t)1 << cell : 0;
+    }
+
+    // checks the children (cell indices) of a node with the board occupied
+    // bit i of occupiedChildren is set if children[i] is already occupied, bit i of connectedChildren if it isn't and its child is connected
+    void evaluate(uint64_t occupied, const int* children, int count, uint32_t& occupiedChildren, uint32_t& connectedChildren) const;
+
+private:
+    int numDirections;
+    int shifts[8]; // how far a cell index moves in each direction (negative is a right shift)
+    uint64_t sources[8]; // the cells that have a neighbor in each direction
+
+    uint64_t grow(uint64_t fill) const; // fill and all its neighbors
+    bool connected(uint64_t board) const;
+#if defined(__AVX2__)
+    uint32_t connected4(__m256i boards) const; // bit i is set if lane i is connected
+#endif
+};
+
+// ----------------------------------------------------------------------------------------------------
+// Implementation
+// ----------------------------------------------------------------------------------------------------
+
+template<typename Delta>
+ChildBatch::ChildBatch(int width, int height, const std::vector<Delta>& directions) : width(width), height(height), cells(width * height),
+        usable(width * height <= 64 && directions.size() <= 8), numDirections(usable ? directions.size() : 0) {
+    if (!usable)
+        return;
+    full = cells == 64 ? ~(uint64_t)0 : ((uint64_t)1 << cells) - 1;
+    for (int dir = 0; dir < numDirections; dir++) {
+        shifts[dir] = directions[dir].y * width + directions[dir].x;
+        sources[dir] = 0;
+        for (int y = 0; y < height; y++) {
+            for (int x = 0; x < width; x++) {
+                int neighborX = x + directions[dir].x, neighborY = y + directions[dir].y;
+                if (neighborX >= 0 && neighborX < width && neighborY >= 0 && neighborY < height)
+                    sources[dir] |= bit(y * width + x);
+            }
+        }
+    }
+}
+
+inline void ChildBatch::evaluate(uint64_t occupied, const int* children, int count, uint32_t& occupiedChildren, uint32_t& connectedChildren) const {
+    occupiedChildren = 0;
+    connectedChildren = 0;
+    for (int i = 0; i < count; i++)
+        if (occupied & bit(children[i]))
+            occupiedChildren |= 1u << i;
+
+#if defined(__AVX2__)
+    // occupied children and unused lanes get a full board, which has nothing to fill
+    // a single free child isn't worth the lanes
+    int freeChildren = count - __builtin_popcount(occupiedChildren);
+    for (int i = 0; i < count && freeChildren == 1; i++)
+        if (!(occupiedChildren & (1u << i)) && connected(occupied | bit(children[i])))
+            connectedChildren |= 1u << i;
+    for (int first = 0; first < count && freeChildren > 1; first += 4) {
+        uint64_t boards[4];
+        for (int lane = 0; lane < 4; lane++) {
+            int i = first + lane;
+            boards[lane] = i < count && !(occupiedChildren & (1u << i)) ? occupied | bit(children[i]) : full;
+        }
+        uint32_t lanes = connected4(_mm256_loadu_si256((const __m256i*)boards));
+        connectedChildren |= (lanes << first) & ~occupiedChildren & ((1u << count) - 1);
+    }
+#else
+    for (int i = 0; i < count; i++)
+        if (!(occupiedChildren & (1u << i)) && connected(occupied | bit(children[i])))
+            connectedChildren |= 1u << i;
+#endif
+}
+
+inline uint64_t ChildBatch::grow(uint64_t fill) const {
+    uint64_t result = fill;
+    for (int dir = 0; dir < numDirections; dir++) {
+        uint64_t source = fill & sources[dir];
+        result |= shifts[dir] > 0 ? source << shifts[dir] : source >> -shifts[dir];
+    }
+    return result;
+}
+
+inline bool ChildBatch::connected(uint64_t board) const {
+    uint64_t free = full & ~board;
+    uint64_t fill = free & (~free + 1); // the first free cell
+    while (true) {
+        uint64_t next = grow(fill) & free;
+        if (next == fill)
+            return fill == free;
+        fill = next;
+    }
+}
+
+#if defined(__AVX2__)
+inline uint32_t ChildBatch::connected4(__m256i boards) const {
+    __m256i free = _mm256_andnot_si256(boards, _mm256_set1_epi64x((long long)full));
+    __m256i fill = _mm256_and_si256(free, _mm256_sub_epi64(_mm256_setzero_si256(), free)); // the first free cell of every lane
+    __m256i laneSources[8];
+    __m128i laneShifts[8];
+    for (int dir = 0; dir < numDirections; dir++) {
+        laneSources[dir] = _mm256_set1_epi64x((long long)sources[dir]);
+        laneShifts[dir] = _mm_cvtsi32_si128(shifts[dir] > 0 ? shifts[dir] : -shifts[dir]);
+    }
+    while (true) {
+        __m256i next = fill;
+        for (int dir = 0; dir < numDirections; dir++) {
+            __m256i source = _mm256_and_si256(fill, laneSources[dir]);
+            next = _mm256_or_si256(next, shifts[dir] > 0 ? _mm256_sll_epi64(source, laneShifts[dir]) : _mm256_srl_epi64(source, laneShifts[dir]));
+        }
+        next = _mm256_and_si256(next, free);
+        // stop once no lane grows anymore
+        if (_mm256_movemask_epi8(_mm256_cmpeq_epi64(next, fill)) == -1)
+            break;
+        fill = next;
+    }
+    return _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(fill, free)));
+}
+#endif
+
+#endif
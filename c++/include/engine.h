@@ -0,0 +1,936 @@
+#pragma once
+
+#ifndef _ENGINE_H_
+#define _ENGINE_H_
+
+#include <iostream>
+#include <vector>
+#include <deque>
+#include <string>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdint.h>
+
+// the exhaustive search that counts every path visiting every cell of a field, shared by main and the library (solver.h)
+// the switches are the ones of main (which defines them before including this), a program that doesn't gets these defaults
+#ifndef FASTER
+#define FASTER true
+#endif
+#ifndef BATCH_CHILDREN
+#define BATCH_CHILDREN true
+#endif
+#ifndef SPECIALIZE_SIZES
+#define SPECIALIZE_SIZES true
+#endif
+#ifndef LARGE_BOARDS
+#define LARGE_BOARDS false
+#endif
+#ifndef COLLECT_STATS
+#define COLLECT_STATS false
+#endif
+#ifndef ESTIMATE_PROBES
+#define ESTIMATE_PROBES 200
+#endif
+#ifndef ESTIMATE_PROBES_TOTAL
+#define ESTIMATE_PROBES_TOTAL 4000
+#endif
+
+#if FASTER
+#include "fastBitmap.h"
+#else
+#include "bitmap.h"
+#endif
+
+#include "arena.h"
+#include "searchStats.h"
+#include "progress.h"
+#include "childBatch.h"
+#include "fixedBoard.h"
+#include "workQueue.h"
+
+#if LARGE_BOARDS
+typedef uint16_t Cell;
+#else
+typedef uint8_t Cell; // a cell index (y * width + x), paths are stored as these instead of Poses
+#endif
+
+// ----------------------------------------------------------------------------------------------------
+// Pos class
+// ----------------------------------------------------------------------------------------------------
+
+class Pos {
+public:
+    Pos(int x = 0, int y = 0) : x(x), y(y) {}
+    ~Pos() {}
+
+    int x, y;
+
+    Pos operator+(Pos other) {
+        return Pos(x + other.x, y + other.y);
+    }
+    Pos operator-(Pos other) {
+        return Pos(x - other.x, y - other.y);
+    }
+};
+
+// ----------------------------------------------------------------------------------------------------
+// NeighborTable class
+// ----------------------------------------------------------------------------------------------------
+
+// precomputed neighbors of every cell for the chosen movement directions
+// a cell index is y * width + x, so moves are table lookups instead of Pos arithmetic and bounds checks
+class NeighborTable {
+public:
+    NeighborTable(int width, int height, std::vector<Pos>& deltaDirections);
+    ~NeighborTable() {}
+
+    int width, height;
+    int maxNeighbors; // the number of movement directions
+    std::vector<int> counts; // the number of valid neighbors of each cell
+    std::vector<int> cells; // the neighbors of cell i are at [i * maxNeighbors, i * maxNeighbors + counts[i])
+    std::vector<Pos> poses; // the Pos of each cell index
+#if BATCH_CHILDREN
+    ChildBatch childBatch; // only usable if the field fits into a 64 bit board
+#endif
+
+    int cellIndex(Pos pos) {
+        return pos.y * width + pos.x;
+    }
+    const int* neighbors(int cell) {
+        return cells.data() + cell * maxNeighbors;
+    }
+};
+
+// ----------------------------------------------------------------------------------------------------
+// SymmetryTable class
+// ----------------------------------------------------------------------------------------------------
+
+// the cell permutations of the mirror symmetries of the field, precomputed so a path is mirrored with one table lookup per cell
+// transform t swaps x and y if t & 4 (only for square fields), then mirrors x if t & 1 and y if t & 2
+class SymmetryTable {
+public:
+    SymmetryTable(int width, int height);
+    ~SymmetryTable() {}
+
+    int width, height;
+    int cells;
+    int numTransforms; // 8 for squares, 4 otherwise
+    std::vector<Cell> permutations; // permutations[transform * cells + cell] is where the transform moves cell to
+
+    const Cell* permutation(int transform) const {
+        return permutations.data() + transform * cells;
+    }
+    // the transforms a solution from the canonical starting cell start has to be mirrored with to get all solutions (the first one is itself)
+    // if x == y you only have to mirror it over x, y and xy
+    // if x != y you also have to swap x and y and mirror that over x, y and xy
+    // if x == size / 2.0 you don't mirror vertically
+    // if y == size / 2.0 you don't mirror horizontally
+    std::vector<int> transformsOf(int start) const;
+};
+
+// ----------------------------------------------------------------------------------------------------
+// Candidate class
+// ----------------------------------------------------------------------------------------------------
+
+class Candidate {
+public:
+    Candidate(int fieldWidth, int fieldHeight) : map(fieldWidth, fieldHeight), path(fieldWidth * fieldHeight, 0) {}
+    Candidate(const Candidate& candidate) = default;
+    Candidate(Candidate&& candidate) noexcept = default; // has to be declared because of the destructor, otherwise every move would copy
+    ~Candidate() {}
+
+    Candidate& operator=(const Candidate& candidate) = default;
+    Candidate& operator=(Candidate&& candidate) noexcept = default;
+
+    Bitmap map; // contains if a pos has been walked on
+    std::vector<Cell> path; // contains the order of the cells (only the first pathIndex are valid)
+    int pathIndex = 0; // the current position in the path vector (instead of push_back)
+#if BATCH_CHILDREN
+    uint64_t board = 0; // the map as one bit per cell (only the first 64 cells)
+#endif
+
+    Pos cellPos(Cell cell) const {
+        return Pos(cell % map.width, cell / map.width);
+    }
+    Cell cellIndex(Pos pos) const {
+        return pos.y * map.width + pos.x;
+    }
+
+    friend std::ostream& operator<<(std::ostream& os, const Candidate& can);
+};
+
+// ----------------------------------------------------------------------------------------------------
+// CandidateStack class
+// ----------------------------------------------------------------------------------------------------
+
+// the depth first search stack of one thread, the candidates are stored back to back in an Arena
+// instead of each owning its own heap memory, so pushing and popping never calls malloc or free
+class CandidateStack {
+public:
+    CandidateStack(Arena& arena, int fieldWidth, int fieldHeight);
+    ~CandidateStack() {}
+
+    bool empty() {
+        return entries.size() == oldest;
+    }
+    void push_back(const Candidate& candidate); // copies the candidate into the arena
+    void popInto(Candidate& candidate); // copies the top candidate into candidate (which has to have the same size) and gives back its memory
+
+    // the bottom candidate is the one closest to the root (the biggest subtree), so it's the one to give to another thread
+    // (there has to be another one left for this thread)
+    bool hasOldest() {
+        return entries.size() > oldest + 1;
+    }
+    const Cell* oldestPath(int& length); // the path of the bottom candidate
+    void dropOldest() { // its memory is given back once the stack is empty
+        oldest++;
+    }
+
+private:
+    struct Entry {
+        Arena::Mark mark; // the arena position before this entry was allocated
+        uint8_t* data;
+    };
+
+    Arena& arena;
+    size_t mapSize, recordSize;
+    std::vector<Entry> entries;
+    size_t oldest = 0; // the entries below were given away
+};
+
+// ----------------------------------------------------------------------------------------------------
+// WorkItems class
+// ----------------------------------------------------------------------------------------------------
+
+// a work item as its start and the moves from there, so it is only a few bytes to copy through the queue
+// (a move is the index of the next cell among the neighbors of the cell before, 4 bits each)
+struct WorkItem {
+    static constexpr int maxLength = 51; // the longest path that fits
+
+    int32_t item; // the starting position for the progress, -1 for parts that were given back while solving
+    uint16_t start;
+    uint8_t length;
+    uint8_t moves[(maxLength - 1) / 2];
+};
+
+// the work items of one field, the threads take them from a lock free queue (instead of a deque behind a mutex)
+// a thread that runs out of items waits while the others are still searching, they give it parts of their subtrees
+// paths too long for a WorkItem (only resumed ones) go to a deque behind a mutex instead
+class WorkItems {
+public:
+    WorkItems(NeighborTable& neighborTable, size_t capacity, bool waitForParts = true);
+    WorkItems(const WorkItems& workItems) = delete;
+    ~WorkItems() {}
+
+    bool waitForParts; // a sweep has the items of the other fields to go to instead
+
+    void add(const Cell* path, int length, int item);
+    bool give(const Cell* path, int length); // a part of a subtree for a waiting thread, false if it doesn't fit
+    bool wantsParts() {
+        return waiting.load(std::memory_order_relaxed) > 0 && queue.empty();
+    }
+    // writes the path of the next item and returns its length, or 0 once there is nothing left
+    // the caller is searching (and can give parts back) until it calls done
+    int next(Cell* path, int& item);
+    void done() {
+        searching--;
+    }
+    // the searches stop at their next node and give back the subtrees they didn't search (like when a --time-limit is over)
+    void stop() {
+        stopped = true;
+    }
+    bool isStopped() {
+        return stopped.load(std::memory_order_relaxed);
+    }
+    void giveBack(Candidate&& candidate); // a subtree a search didn't get to because of stop
+    // the items that were never taken and the subtrees that were given back
+    std::deque<Candidate> remaining(int width, int height);
+
+private:
+    NeighborTable& neighborTable;
+    WorkQueue<WorkItem> queue;
+    std::mutex overflowMutex;
+    std::deque<std::pair<int, std::vector<Cell>>> overflow;
+    std::atomic<size_t> overflowSize{0};
+    std::atomic<int> searching{0}, waiting{0};
+    std::atomic<bool> stopped{false};
+    std::mutex givenBackMutex;
+    std::deque<Candidate> givenBack;
+
+    bool encode(const Cell* path, int length, int item, WorkItem& workItem);
+};
+
+// ----------------------------------------------------------------------------------------------------
+// search functions
+// ----------------------------------------------------------------------------------------------------
+
+// the Result of a search is what one thread writes into (so the threads don't share anything while solving)
+// it needs addSolution(const Cell* path), which gets every path that visits every cell (only valid during the call),
+// a uint64_t nodes that the searched nodes are added to and with COLLECT_STATS a SearchStats stats
+
+// searches the work items until there are none left or they are stopped
+// progress can be nullptr, otherwise it has an estimate for every item number of the work items
+template<typename Result>
+void solveItems(int sizeX, int sizeY, WorkItems* workItems, Result* result, NeighborTable* neighborTable, Progress* progress);
+template<typename Result>
+using SolveFunction = void (*)(int sizeX, int sizeY, WorkItems* workItems, Result* result, NeighborTable* neighborTable, Progress* progress);
+#if SPECIALIZE_SIZES
+// solveItems for a W x H field with the 4 straight directions, the whole subtree of a work item is walked in place on one path and one board
+// (no candidates are copied, every depth only remembers which of its children are left)
+template<int W, int H, typename Result>
+void solveFixed(int sizeX, int sizeY, WorkItems* workItems, Result* result, NeighborTable* neighborTable, Progress* progress);
+// records the solutions among the children of the path and returns which children (bits of FixedBoard<W, H>::neighbors) have to be walked to
+template<int W, int H, typename Result>
+uint32_t expandFixed(Result& result, Cell* path, int length, uint64_t board);
+// the solveFixed for the size, or nullptr if there is none
+template<typename Result>
+SolveFunction<Result> fixedSolve(int width, int height, std::vector<Pos>& deltaDirections);
+#endif
+// tries to extend the candidate with each of its neighbors
+template<typename Candidates, typename Result>
+void expand(Candidates& candidates, Result& result, NeighborTable& neighborTable, Candidate& candidate, Bitmap& toCheck);
+// what a step leads to
+enum class Step {
+    OCCUPIED,
+    DISCONNECTED,
+    CANDIDATE,
+    SOLUTION
+};
+
+// extends the candidate by nextCell (if its not occupied) and checks what that leads to
+// unless the step was OCCUPIED it has to be undone with retreat
+Step advance(Candidate& candidate, NeighborTable& neighborTable, int nextCell, Bitmap& toCheck);
+void retreat(Candidate& candidate);
+
+// if the nextCell creates a valid candidate that is not a solution it adds it to candidates or if its a solution to the result
+// nextCell has to come from the neighborTable so it is always inside the field
+// the candidate is extended in place and restored before returning, toCheck is scratch memory for connected()
+template<typename Candidates, typename Result>
+Step validateAndAdd(Candidates& candidates, Result& result, NeighborTable& neighborTable, Candidate& candidate, int nextCell, Bitmap& toCheck);
+bool checkFinished(Candidate& candidate);
+bool connected(Candidate& candidate, NeighborTable& neighborTable, Bitmap& toCheck);
+int floodFill(Bitmap& toFill, bool valToFill, int currCell, NeighborTable& neighborTable);
+
+// the result of one random probe down the search tree (Knuth's estimator), averaged over many probes they are unbiased estimates
+struct ProbeEstimate {
+    double nodes = 0; // nodes that would be expanded in the subtree (including the candidate itself)
+    double solutions = 0;
+};
+// walks from the candidate down one random path, choosing uniformly between the children the search would keep
+ProbeEstimate probeTree(Candidate candidate, NeighborTable& neighborTable, Bitmap& toCheck, std::mt19937_64& rng);
+int probesPerItem(size_t numItems); // ESTIMATE_PROBES, fewer once there are too many items for ESTIMATE_PROBES_TOTAL
+void applyToEntirePath(const Cell* path, Cell* result, const Cell* permutation, int length); // writes the path with every cell moved by the permutation into result
+// the starting positions that are left when the mirror symmetries of the field are taken out
+// (on fields with an odd number of cells only the cells with the color of the corners can start a solution)
+std::deque<Candidate> canonicalStartingPoses(int width, int height);
+// the cells of those starting positions
+std::vector<int> canonicalStartCells(int width, int height);
+// expands starting positions until there are at least numItems of them (solutions found on the way go into result)
+template<typename Result>
+void splitStartingPoses(std::deque<Candidate>& startingPoses, Result& result, NeighborTable& neighborTable, Bitmap& toCheck, size_t numItems);
+// a candidate that has walked the first length cells of path
+Candidate prefixCandidate(int width, int height, const Cell* path, int length);
+
+// ----------------------------------------------------------------------------------------------------
+// Implementation
+// ----------------------------------------------------------------------------------------------------
+
+inline std::ostream& operator<<(std::ostream& os, const Candidate& can) {
+    int digits = std::to_string(can.map.width * can.map.height - 1).size();
+    os << std::endl;
+    std::vector<std::vector<std::string>> values(can.map.height, std::vector<std::string>(can.map.width, std::string(digits, '-')));
+    for (int i = 0; i < can.path.size() && i < can.pathIndex; i++) {
+        std::string iString = std::to_string(i);
+        Pos pos = can.cellPos(can.path[i]);
+        values[pos.y][pos.x] = std::string(digits - iString.size(), '0') + iString;
+    }
+    for (int y = 0; y < can.map.height; y++) {
+        for (int x = 0; x < can.map.width; x++)
+            os << values[y][x] << " ";
+        os << std::endl;
+    }
+    return os;
+}
+
+inline NeighborTable::NeighborTable(int width, int height, std::vector<Pos>& deltaDirections) : width(width), height(height), maxNeighbors(deltaDirections.size()),
+        counts(width * height, 0), cells(width * height * deltaDirections.size(), -1), poses(width * height)
+#if BATCH_CHILDREN
+        , childBatch(width, height, deltaDirections)
+#endif
+        {
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            int cell = cellIndex(Pos(x, y));
+            poses[cell] = Pos(x, y);
+            for (int dir = 0; dir < maxNeighbors; dir++) {
+                Pos neighbor = Pos(x, y) + deltaDirections[dir];
+                if (neighbor.x < 0 || neighbor.x >= width || neighbor.y < 0 || neighbor.y >= height)
+                    continue;
+                cells[cell * maxNeighbors + counts[cell]] = cellIndex(neighbor);
+                counts[cell]++;
+            }
+        }
+    }
+}
+
+inline SymmetryTable::SymmetryTable(int width, int height) : width(width), height(height), cells(width * height), numTransforms(width == height ? 8 : 4),
+        permutations(numTransforms * width * height) {
+    for (int transform = 0; transform < numTransforms; transform++) {
+        for (int y = 0; y < height; y++) {
+            for (int x = 0; x < width; x++) {
+                Pos curr = transform & 4 ? Pos(y, x) : Pos(x, y);
+                if (transform & 1)
+                    curr.x = width - curr.x - 1;
+                if (transform & 2)
+                    curr.y = height - curr.y - 1;
+                permutations[transform * cells + y * width + x] = curr.y * width + curr.x;
+            }
+        }
+    }
+}
+
+inline std::vector<int> SymmetryTable::transformsOf(int start) const {
+    std::vector<int> transforms;
+    Pos startPos(start % width, start / width);
+    for (int transpose = 0; transpose < (startPos.x != startPos.y && width == height ? 2 : 1); transpose++) {
+        Pos variantStart = transpose ? Pos(startPos.y, startPos.x) : startPos;
+        bool canMirrorX = variantStart.x != (width - 1) / 2.0;
+        bool canMirrorY = variantStart.y != (height - 1) / 2.0;
+        for (int mirror = 0; mirror < 4; mirror++) {
+            bool mirrorX = mirror & 1;
+            bool mirrorY = mirror & 2;
+            if ((mirrorX && !canMirrorX) || (mirrorY && !canMirrorY))
+                continue;
+            transforms.push_back(transpose * 4 + mirror);
+        }
+    }
+    return transforms;
+}
+
+inline CandidateStack::CandidateStack(Arena& arena, int fieldWidth, int fieldHeight) : arena(arena) {
+    mapSize = Bitmap(fieldWidth, fieldHeight).rawSize();
+    recordSize = sizeof(int) + mapSize + fieldWidth * fieldHeight * sizeof(Cell);
+#if BATCH_CHILDREN
+    recordSize += sizeof(uint64_t);
+#endif
+}
+
+inline void CandidateStack::push_back(const Candidate& candidate) {
+    Entry entry;
+    entry.mark = arena.mark();
+    entry.data = (uint8_t*)arena.allocate(recordSize);
+    std::memcpy(entry.data, &candidate.pathIndex, sizeof(int));
+    candidate.map.copyTo(entry.data + sizeof(int));
+    std::memcpy(entry.data + sizeof(int) + mapSize, candidate.path.data(), candidate.pathIndex * sizeof(Cell));
+#if BATCH_CHILDREN
+    std::memcpy(entry.data + recordSize - sizeof(uint64_t), &candidate.board, sizeof(uint64_t));
+#endif
+    entries.push_back(entry);
+}
+
+inline void CandidateStack::popInto(Candidate& candidate) {
+    Entry entry = entries.back();
+    entries.pop_back();
+    if (entries.size() == oldest && oldest > 0) { // everything else was given away
+        entry.mark = entries[0].mark;
+        entries.clear();
+        oldest = 0;
+    }
+    std::memcpy(&candidate.pathIndex, entry.data, sizeof(int));
+    candidate.map.copyFrom(entry.data + sizeof(int));
+    std::memcpy(candidate.path.data(), entry.data + sizeof(int) + mapSize, candidate.pathIndex * sizeof(Cell));
+#if BATCH_CHILDREN
+    std::memcpy(&candidate.board, entry.data + recordSize - sizeof(uint64_t), sizeof(uint64_t));
+#endif
+    arena.rewind(entry.mark);
+}
+
+inline const Cell* CandidateStack::oldestPath(int& length) {
+    std::memcpy(&length, entries[oldest].data, sizeof(int));
+    return (const Cell*)(entries[oldest].data + sizeof(int) + mapSize);
+}
+
+inline WorkItems::WorkItems(NeighborTable& neighborTable, size_t capacity, bool waitForParts) : waitForParts(waitForParts), neighborTable(neighborTable),
+        queue(std::max(capacity, (size_t)64)) {}
+
+inline void WorkItems::add(const Cell* path, int length, int item) {
+    WorkItem workItem;
+    if (encode(path, length, item, workItem) && queue.push(workItem))
+        return;
+    std::lock_guard<std::mutex> lock(overflowMutex);
+    overflow.emplace_back(item, std::vector<Cell>(path, path + length));
+    overflowSize++;
+}
+
+inline bool WorkItems::give(const Cell* path, int length) {
+    WorkItem workItem;
+    return encode(path, length, -1, workItem) && queue.push(workItem);
+}
+
+inline int WorkItems::next(Cell* path, int& item) {
+    WorkItem workItem;
+    waiting++;
+    for (int round = 0; ; round++) {
+        // searching goes up before an item is taken (and back down if there was none), so while this thread holds an item it
+        // is already counted and the others can't see searching at 0 and stop waiting for the parts it will give
+        searching++;
+        if (queue.pop(workItem)) {
+            waiting--;
+            item = workItem.item;
+            path[0] = workItem.start;
+            for (int i = 1; i < workItem.length; i++)
+                path[i] = neighborTable.neighbors(path[i - 1])[(workItem.moves[(i - 1) / 2] >> ((i - 1) % 2 * 4)) & 15];
+            return workItem.length;
+        }
+        if (overflowSize.load(std::memory_order_relaxed) > 0) {
+            std::lock_guard<std::mutex> lock(overflowMutex);
+            if (!overflow.empty()) {
+                waiting--;
+                overflowSize--;
+                item = overflow.back().first;
+                std::copy(overflow.back().second.begin(), overflow.back().second.end(), path);
+                int length = overflow.back().second.size();
+                overflow.pop_back();
+                return length;
+            }
+        }
+        searching--;
+        if (!waitForParts || searching.load() == 0 || isStopped())
+            break;
+        // parts only come every few thousand nodes, so a thread that waits longer doesn't need to take the core from the others
+        if (round < 64)
+            std::this_thread::yield();
+        else
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+    waiting--;
+    return 0;
+}
+
+inline void WorkItems::giveBack(Candidate&& candidate) {
+    std::lock_guard<std::mutex> lock(givenBackMutex);
+    givenBack.push_back(std::move(candidate));
+}
+
+inline std::deque<Candidate> WorkItems::remaining(int width, int height) {
+    std::deque<Candidate> result;
+    std::vector<Cell> path(width * height);
+    int item;
+    for (int length = next(path.data(), item); length > 0; length = next(path.data(), item)) {
+        result.push_back(prefixCandidate(width, height, path.data(), length));
+        done();
+    }
+    std::lock_guard<std::mutex> lock(givenBackMutex);
+    for (int i = 0; i < givenBack.size(); i++)
+        result.push_back(std::move(givenBack[i]));
+    givenBack.clear();
+    return result;
+}
+
+inline bool WorkItems::encode(const Cell* path, int length, int item, WorkItem& workItem) {
+    if (length > WorkItem::maxLength)
+        return false;
+    workItem = WorkItem{};
+    workItem.item = item;
+    workItem.start = path[0];
+    workItem.length = length;
+    for (int i = 1; i < length; i++) {
+        const int* neighbors = neighborTable.neighbors(path[i - 1]);
+        int move = 0;
+        while (neighbors[move] != path[i])
+            move++;
+        workItem.moves[(i - 1) / 2] |= move << ((i - 1) % 2 * 4);
+    }
+    return true;
+}
+
+template<typename Result>
+void solveItems(int sizeX, int sizeY, WorkItems* workItems, Result* result, NeighborTable* neighborTable, Progress* progress) {
+    thread_local Arena arena; // all the candidates of this thread live in here (and stay there for the next solve on the same thread)
+    CandidateStack candidates(arena, sizeX, sizeY);
+    Candidate currCandidate(sizeX, sizeY); // the candidate that is currently expanded (reused for every node)
+    Bitmap toCheck(sizeX, sizeY);
+    std::vector<Cell> itemPath(sizeX * sizeY);
+    int item;
+
+    while (!workItems->isStopped()) {
+        int length = workItems->next(itemPath.data(), item);
+        if (length == 0)
+            break;
+        candidates.push_back(prefixCandidate(sizeX, sizeY, itemPath.data(), length));
+        uint64_t itemNodes = 0;
+
+        // the whole subtree of the work item lives in the arena and is given back as the stack empties
+        while (!candidates.empty()) {
+            if (workItems->isStopped()) { // the candidates left on the stack are the subtrees that weren't searched
+                while (!candidates.empty()) {
+                    candidates.popInto(currCandidate);
+                    workItems->giveBack(Candidate(currCandidate));
+                }
+                result->nodes += itemNodes;
+                workItems->done();
+                return;
+            }
+            candidates.popInto(currCandidate);
+            expand(candidates, *result, *neighborTable, currCandidate, toCheck);
+            itemNodes++;
+            if (progress != nullptr && itemNodes % 4096 == 0)
+                progress->addNodes(4096);
+            if (itemNodes % 1024 == 0 && workItems->wantsParts() && candidates.hasOldest()) {
+                int oldestLength;
+                const Cell* oldestPath = candidates.oldestPath(oldestLength);
+                if (workItems->give(oldestPath, oldestLength))
+                    candidates.dropOldest();
+            }
+        }
+        workItems->done();
+        result->nodes += itemNodes;
+
+        if (progress != nullptr) {
+            progress->addNodes(itemNodes % 4096);
+            progress->finishItem(item, itemNodes);
+        }
+    }
+}
+
+#if SPECIALIZE_SIZES
+template<int W, int H, typename Result>
+void solveFixed(int sizeX, int sizeY, WorkItems* workItems, Result* result, NeighborTable* neighborTable, Progress* progress) {
+    typedef FixedBoard<W, H> Board;
+    (void)neighborTable; // only for the signature of a SolveFunction, the neighbors are compiled into the Board
+    Cell path[Board::cells];
+    Cell part[Board::cells]; // the path of a subtree that is given to another thread
+    uint32_t pending[Board::cells]; // pending[length] are the children of the node with that path length that are left
+    int item;
+
+    while (!workItems->isStopped()) {
+        int startLength = workItems->next(path, item);
+        if (startLength == 0)
+            break;
+        uint64_t board = 0;
+        for (int i = 0; i < startLength; i++)
+            board |= Board::bit(path[i]);
+        int length = startLength;
+        pending[length] = expandFixed<W, H>(*result, path, length, board);
+        uint64_t itemNodes = 1;
+
+        while (true) {
+            if (workItems->isStopped()) { // the pending children of every depth are the subtrees that weren't searched
+                for (int depth = length; depth >= startLength; depth--) { // the deepest first, setting path[depth] changes the paths of the deeper ones
+                    for (uint32_t children = pending[depth]; children != 0; children &= children - 1) {
+                        path[depth] = Board::neighbors[path[depth - 1]].cells[__builtin_ctz(children)];
+                        workItems->giveBack(prefixCandidate(sizeX, sizeY, path, depth + 1));
+                    }
+                }
+                result->nodes += itemNodes;
+                workItems->done();
+                return;
+            }
+            if (pending[length] == 0) { // back to the parent
+                if (length == startLength)
+                    break;
+                length--;
+                board &= ~Board::bit(path[length]);
+                continue;
+            }
+            int child = __builtin_ctz(pending[length]);
+            pending[length] &= pending[length] - 1;
+            path[length] = Board::neighbors[path[length - 1]].cells[child];
+            board |= Board::bit(path[length]);
+            length++;
+            pending[length] = expandFixed<W, H>(*result, path, length, board);
+            itemNodes++;
+            if (progress != nullptr && itemNodes % 4096 == 0)
+                progress->addNodes(4096);
+            if (itemNodes % 1024 == 0 && workItems->wantsParts()) { // the shallowest pending child is the biggest subtree
+                for (int depth = startLength; depth < length; depth++) {
+                    if (pending[depth] == 0)
+                        continue;
+                    std::memcpy(part, path, depth * sizeof(Cell));
+                    part[depth] = Board::neighbors[path[depth - 1]].cells[__builtin_ctz(pending[depth])];
+                    if (workItems->give(part, depth + 1))
+                        pending[depth] &= pending[depth] - 1;
+                    break;
+                }
+            }
+        }
+        workItems->done();
+        result->nodes += itemNodes;
+
+        if (progress != nullptr) {
+            progress->addNodes(itemNodes % 4096);
+            progress->finishItem(item, itemNodes);
+        }
+    }
+}
+
+template<int W, int H, typename Result>
+uint32_t expandFixed(Result& result, Cell* path, int length, uint64_t board) {
+    typedef FixedBoard<W, H> Board;
+    int currCell = path[length - 1];
+    const typename Board::Neighbors& neighbors = Board::neighbors[currCell];
+    uint32_t occupiedChildren = 0, children = 0;
+    int solutions = 0;
+
+    if (length + 1 == Board::cells) { // every free neighbor is the last cell
+        for (int i = 0; i < neighbors.count; i++) {
+            if (board & Board::bit(neighbors.cells[i])) {
+                occupiedChildren |= 1u << i;
+                continue;
+            }
+            path[length] = neighbors.cells[i];
+            result.addSolution(path);
+            solutions++;
+        }
+    }
+    else
+        children = Board::evaluate(board, currCell, occupiedChildren);
+
+#if COLLECT_STATS
+    int occupied = __builtin_popcount(occupiedChildren);
+    result.stats.addNode(path[0], length, Board::maxNeighbors - neighbors.count, occupied,
+        neighbors.count - occupied - solutions - __builtin_popcount(children), solutions);
+#else
+    (void)solutions;
+#endif
+    return children;
+}
+
+template<typename Result>
+SolveFunction<Result> fixedSolve(int width, int height, std::vector<Pos>& deltaDirections) {
+    static const SolveFunction<Result> solveFunctions[] = {
+        solveFixed<2, 2, Result>, solveFixed<3, 3, Result>, solveFixed<4, 4, Result>, solveFixed<5, 5, Result>,
+        solveFixed<6, 6, Result>, solveFixed<7, 7, Result>, solveFixed<8, 8, Result>
+    };
+    if (deltaDirections.size() != 4 || width != height || width < 2 || width > 8)
+        return nullptr;
+    for (int dir = 0; dir < deltaDirections.size(); dir++)
+        if (std::abs(deltaDirections[dir].x) + std::abs(deltaDirections[dir].y) != 1)
+            return nullptr;
+    return solveFunctions[width - 2];
+}
+#endif
+
+template<typename Candidates, typename Result>
+void expand(Candidates& candidates, Result& result, NeighborTable& neighborTable, Candidate& candidate, Bitmap& toCheck) {
+    int currCell = candidate.path[candidate.pathIndex - 1];
+#if COLLECT_STATS
+    uint64_t steps[4] = {}; // how often each Step happened
+#endif
+
+    // try to create candidates with each neighbor
+    const int* neighbors = neighborTable.neighbors(currCell);
+#if BATCH_CHILDREN
+    if (neighborTable.childBatch.usable) {
+        // all children are checked at once, only the ones that are kept are walked to
+        uint32_t occupiedChildren = 0, connectedChildren = 0;
+        bool last = candidate.pathIndex + 1 >= neighborTable.width * neighborTable.height;
+        if (last) {
+            for (int i = 0; i < neighborTable.counts[currCell]; i++)
+                if (candidate.board & ChildBatch::bit(neighbors[i]))
+                    occupiedChildren |= 1u << i;
+        }
+        else
+            neighborTable.childBatch.evaluate(candidate.board, neighbors, neighborTable.counts[currCell], occupiedChildren, connectedChildren);
+
+        for (int i = 0; i < neighborTable.counts[currCell]; i++) {
+            Step step = occupiedChildren & (1u << i) ? Step::OCCUPIED : last ? Step::SOLUTION : connectedChildren & (1u << i) ? Step::CANDIDATE : Step::DISCONNECTED;
+#if COLLECT_STATS
+            steps[(int)step]++;
+#endif
+            if (step == Step::OCCUPIED || step == Step::DISCONNECTED)
+                continue;
+            candidate.path[candidate.pathIndex] = neighbors[i];
+            candidate.pathIndex++;
+            if (step == Step::SOLUTION)
+                result.addSolution(candidate.path.data());
+            else {
+                candidate.map.setCell(neighbors[i], true);
+                candidate.board |= ChildBatch::bit(neighbors[i]);
+                candidates.push_back(candidate);
+                candidate.map.setCell(neighbors[i], false);
+                candidate.board &= ~ChildBatch::bit(neighbors[i]);
+            }
+            candidate.pathIndex--;
+        }
+    }
+    else
+#endif
+    for (int i = 0; i < neighborTable.counts[currCell]; i++) {
+        Step step = validateAndAdd(candidates, result, neighborTable, candidate, neighbors[i], toCheck);
+#if COLLECT_STATS
+        steps[(int)step]++;
+#else
+        (void)step;
+#endif
+    }
+
+#if COLLECT_STATS
+    result.stats.addNode(candidate.path[0], candidate.pathIndex, neighborTable.maxNeighbors - neighborTable.counts[currCell],
+        steps[(int)Step::OCCUPIED], steps[(int)Step::DISCONNECTED], steps[(int)Step::SOLUTION]);
+#endif
+}
+
+template<typename Candidates, typename Result>
+Step validateAndAdd(Candidates& candidates, Result& result, NeighborTable& neighborTable, Candidate& candidate, int nextCell, Bitmap& toCheck) {
+    Step step = advance(candidate, neighborTable, nextCell, toCheck);
+    if (step == Step::OCCUPIED)
+        return step;
+    if (step == Step::SOLUTION)
+        result.addSolution(candidate.path.data()); // only the path is stored, the map is no longer needed after its a solution
+    else if (step == Step::CANDIDATE)
+        candidates.push_back(candidate);
+
+    // undo the step so the candidate can be extended in the next direction
+    retreat(candidate);
+    return step;
+}
+
+inline Step advance(Candidate& candidate, NeighborTable& neighborTable, int nextCell, Bitmap& toCheck) {
+    if (candidate.map.getCell(nextCell))
+        return Step::OCCUPIED;
+    candidate.path[candidate.pathIndex] = nextCell;
+    candidate.pathIndex++;
+    candidate.map.setCell(nextCell, true);
+#if BATCH_CHILDREN
+    candidate.board |= ChildBatch::bit(nextCell);
+#endif
+    if (checkFinished(candidate))
+        return Step::SOLUTION;
+    if (connected(candidate, neighborTable, toCheck))
+        return Step::CANDIDATE;
+    return Step::DISCONNECTED;
+}
+
+inline void retreat(Candidate& candidate) {
+    candidate.pathIndex--;
+    candidate.map.setCell(candidate.path[candidate.pathIndex], false);
+#if BATCH_CHILDREN
+    candidate.board &= ~ChildBatch::bit(candidate.path[candidate.pathIndex]);
+#endif
+}
+
+inline bool checkFinished(Candidate& candidate) {
+    return candidate.pathIndex >= candidate.map.width * candidate.map.height;
+}
+
+inline bool connected(Candidate& candidate, NeighborTable& neighborTable, Bitmap& toCheck) {
+    int startCell = candidate.map.findFirst(false);
+    if (startCell < 0) // nothing left to connect
+        return true;
+
+    toCheck.copyFrom(candidate.map);
+    int numTiles = floodFill(toCheck, false, startCell, neighborTable);
+    return numTiles == (candidate.map.width * candidate.map.height - candidate.pathIndex); // checks if the num of connected tiles is the num of the remaining tiles
+}
+
+inline int floodFill(Bitmap& toFill, bool valToFill, int currCell, NeighborTable& neighborTable) {
+    if (toFill.getCell(currCell) != valToFill)
+        return 0;
+    
+    toFill.setCell(currCell, !valToFill);
+    int sum = 1; // 1 is for this tile
+    const int* neighbors = neighborTable.neighbors(currCell);
+    for (int i = 0; i < neighborTable.counts[currCell]; i++)
+        sum += floodFill(toFill, valToFill, neighbors[i], neighborTable);
+    return sum;
+}
+
+inline ProbeEstimate probeTree(Candidate candidate, NeighborTable& neighborTable, Bitmap& toCheck, std::mt19937_64& rng) {
+    ProbeEstimate estimate;
+    estimate.nodes = 1;
+    double weight = 1; // the number of nodes on this level that the current one stands for
+    std::vector<int> children(neighborTable.maxNeighbors);
+
+    while (true) {
+        int currCell = candidate.path[candidate.pathIndex - 1];
+        const int* neighbors = neighborTable.neighbors(currCell);
+        int numChildren = 0;
+        for (int i = 0; i < neighborTable.counts[currCell]; i++) {
+            Step step = advance(candidate, neighborTable, neighbors[i], toCheck);
+            if (step == Step::OCCUPIED)
+                continue;
+            retreat(candidate);
+            if (step != Step::DISCONNECTED)
+                children[numChildren++] = neighbors[i];
+        }
+        if (numChildren == 0)
+            return estimate;
+
+        weight *= numChildren;
+        if (advance(candidate, neighborTable, children[rng() % numChildren], toCheck) == Step::SOLUTION) {
+            estimate.solutions += weight;
+            return estimate;
+        }
+        estimate.nodes += weight;
+    }
+}
+
+inline int probesPerItem(size_t numItems) {
+    return (int)std::clamp(ESTIMATE_PROBES_TOTAL / std::max(numItems, (size_t)1), (size_t)1, (size_t)ESTIMATE_PROBES);
+}
+
+inline std::deque<Candidate> canonicalStartingPoses(int width, int height) {
+    std::deque<Candidate> startingPoses;
+    std::vector<int> startCells = canonicalStartCells(width, height);
+    for (int i = 0; i < startCells.size(); i++) {
+        Candidate can(width, height);
+        can.path[can.pathIndex] = startCells[i];
+        can.pathIndex++;
+        can.map[startCells[i] / width][startCells[i] % width] = true;
+#if BATCH_CHILDREN
+        can.board |= ChildBatch::bit(startCells[i]);
+#endif
+        startingPoses.push_back(std::move(can));
+    }
+    return startingPoses;
+}
+
+inline std::vector<int> canonicalStartCells(int width, int height) {
+    std::vector<int> startCells;
+    for (int x = 0; x < std::ceil(width / 2.0); x++) {
+        for (int y = 0; y < std::ceil(height / 2.0); y++) {
+            if (width == height && y > x) // the transposed start is the same
+                break;
+            if ((x + y) % 2 == 1 && width * height % 2 == 1)
+                continue;
+            startCells.push_back(y * width + x);
+        }
+    }
+    return startCells;
+}
+
+template<typename Result>
+void splitStartingPoses(std::deque<Candidate>& startingPoses, Result& result, NeighborTable& neighborTable, Bitmap& toCheck, size_t numItems) {
+    for (size_t i = startingPoses.size(); i < numItems && i > 0;) {
+        Candidate currCan = std::move(startingPoses.back());
+        startingPoses.pop_back();
+        expand(startingPoses, result, neighborTable, currCan, toCheck);
+        i = startingPoses.size();
+    }
+}
+
+inline void applyToEntirePath(const Cell* path, Cell* result, const Cell* permutation, int length) {
+    for (int i = 0; i < length; i++)
+        result[i] = permutation[path[i]];
+}
+
+inline Candidate prefixCandidate(int width, int height, const Cell* path, int length) {
+    Candidate can(width, height);
+    for (int i = 0; i < length; i++) {
+        can.path[can.pathIndex++] = path[i];
+        can.map.setCell(path[i], true);
+#if BATCH_CHILDREN
+        can.board |= ChildBatch::bit(path[i]);
+#endif
+    }
+    return can;
+}
+
+#endif
@@ -6,9 +6,22 @@
 #include <iostream>
 #include <math.h>
 #include <stdint.h>
+#include <cstring>
+#include <algorithm>
+
+// can be defined before including this to count or redirect the allocations of the bitmaps
+#ifndef BITMAP_MALLOC
+#define BITMAP_MALLOC(size) std::malloc(size)
+#endif
+#ifndef BITMAP_FREE
+#define BITMAP_FREE(ptr) std::free(ptr)
+#endif
+
+#define BITMAP_ALIGNMENT 64 // the data block starts at a cache line
 
 // this is a faster but less data efficient Bitmap class then bitmap.h
 // its made to be as interchagebale possible so you can switch the verion simply with precompiler commands
+// all cells are stored in one block (one byte per cell), so copying is a single memcpy
 
 // ----------------------------------------------------------------------------------------------------
 // Bitmap class
@@ -17,62 +30,239 @@
 class Bitmap {
 public:
     Bitmap(const Bitmap& bitmap); // this constructor ensures that all the data is copied when passed into a function
+    Bitmap(Bitmap&& bitmap) noexcept; // takes over the data of bitmap without copying
     Bitmap(int width, int height, bool defaultValue = false);
     ~Bitmap();
 
+    Bitmap& operator=(const Bitmap& bitmap); // reuses the own block if the sizes match
+    Bitmap& operator=(Bitmap&& bitmap) noexcept;
+
     int width, height;
-    bool** data = nullptr;
+    int stride; // the distance between two rows in data (equal to width so a cell index y * width + x is also the offset in data)
+    bool* data = nullptr; // all the cells row by row (cache line aligned)
+    void* block = nullptr; // the allocation data lives in
 
-    bool get(int x, int y);
+    bool get(int x, int y) const;
     void set(int x, int y, bool value);
+    bool getCell(int cell) const {
+        return data[cell];
+    }
+    void setCell(int cell, bool value) {
+        data[cell] = value;
+    }
+
+    // the same bulk operations as bitmap.h, a byte per cell at a time (the loops are simple enough to be vectorized)
+    int count() const; // the number of set cells
+    int findFirst(bool value = true) const; // the first cell that is value, -1 if there is none
+    int findNext(int cell, bool value = true) const; // the first cell after cell that is value, -1 if there is none
+    template<typename Function>
+    void forEachSet(Function function) const; // calls function(cell) for every set cell in order
+    void fill(bool value);
+    void invert();
+    // the boolean operations need a bitmap with the same size
+    Bitmap& operator&=(const Bitmap& bitmap);
+    Bitmap& operator|=(const Bitmap& bitmap);
+    Bitmap& andNot(const Bitmap& bitmap); // clears every cell that is set in bitmap
+    bool operator==(const Bitmap& bitmap) const;
+    bool operator!=(const Bitmap& bitmap) const {
+        return !(*this == bitmap);
+    }
+    // moves every cell dx columns to the right and dy rows down (negative is left and up)
+    // cells that are moved out of the field are dropped and the cells that are moved in are cleared
+    void shift(int dx, int dy);
+
+    size_t rawSize() const; // the number of bytes copyTo writes and copyFrom reads
+    void copyTo(uint8_t* dest) const;
+    void copyFrom(const uint8_t* src);
+    void copyFrom(const Bitmap& bitmap); // copies the data of a bitmap with the same size without reallocating
 #ifdef INCLUDE_STB_IMAGE_WRITE_H // checks if stb_image_write.h was included (this is just to avoid unneccecery headers)
     void outputAsBitmap(const char* filepath);
 #endif
 
     bool* operator[](int y);
-    friend std::ostream& operator<<(std::ostream& os, Bitmap bitmap);
+    friend std::ostream& operator<<(std::ostream& os, const Bitmap& bitmap);
+
+private:
+    void allocate();
+    void release();
+    void checkSize(const Bitmap& bitmap) const;
 };
 
-Bitmap::Bitmap(const Bitmap& bitmap) : width(bitmap.width), height(bitmap.height) {
+inline Bitmap::Bitmap(const Bitmap& bitmap) : width(bitmap.width), height(bitmap.height), stride(bitmap.stride) {
     if (bitmap.data == nullptr)
         return;
-    data = (bool**)std::malloc(height * sizeof(bool*));
-    for (int y = 0; y < height; y++) {
-        bool* row = (bool*)std::malloc(width * sizeof(bool));
-        std::copy(bitmap.data[y], bitmap.data[y] + width, row);
-        data[y] = row;
+    allocate();
+    std::memcpy(data, bitmap.data, rawSize());
+}
+
+inline Bitmap::Bitmap(Bitmap&& bitmap) noexcept : width(bitmap.width), height(bitmap.height), stride(bitmap.stride), data(bitmap.data), block(bitmap.block) {
+    bitmap.data = nullptr;
+    bitmap.block = nullptr;
+}
+
+inline Bitmap::Bitmap(int width, int height, bool defaultValue) : width(width), height(height), stride(width) {
+    allocate();
+    std::memset(data, defaultValue, rawSize());
+}
+
+inline Bitmap::~Bitmap() {
+    release();
+}
+
+inline Bitmap& Bitmap::operator=(const Bitmap& bitmap) {
+    if (this == &bitmap)
+        return *this;
+    if (data != nullptr && bitmap.data != nullptr && width == bitmap.width && height == bitmap.height) {
+        copyFrom(bitmap);
+        return *this;
     }
+    Bitmap copy(bitmap);
+    return *this = std::move(copy);
+}
+
+inline Bitmap& Bitmap::operator=(Bitmap&& bitmap) noexcept {
+    if (this == &bitmap)
+        return *this;
+    release();
+    width = bitmap.width;
+    height = bitmap.height;
+    stride = bitmap.stride;
+    data = bitmap.data;
+    block = bitmap.block;
+    bitmap.data = nullptr;
+    bitmap.block = nullptr;
+    return *this;
+}
+
+inline void Bitmap::allocate() {
+    block = BITMAP_MALLOC(rawSize() + BITMAP_ALIGNMENT - 1);
+    if (block == nullptr)
+        throw std::bad_alloc();
+    data = (bool*)(((uintptr_t)block + BITMAP_ALIGNMENT - 1) & ~(uintptr_t)(BITMAP_ALIGNMENT - 1));
+}
+
+inline void Bitmap::release() {
+    if (block != nullptr)
+        BITMAP_FREE(block);
+    block = nullptr;
+    data = nullptr;
+}
+
+inline bool Bitmap::get(int x, int y) const {
+    return data[y * stride + x];
+}
+
+inline void Bitmap::set(int x, int y, bool value) {
+    data[y * stride + x] = value;
+}
+
+inline int Bitmap::count() const {
+    int sum = 0;
+    for (int i = 0; i < width * height; i++)
+        sum += data[i];
+    return sum;
+}
+
+inline int Bitmap::findFirst(bool value) const {
+    return findNext(-1, value);
+}
+
+inline int Bitmap::findNext(int cell, bool value) const {
+    int first = cell + 1;
+    if (first >= width * height)
+        return -1;
+    const void* found = std::memchr(data + first, value, width * height - first);
+    return found != nullptr ? (const bool*)found - data : -1;
+}
+
+template<typename Function>
+void Bitmap::forEachSet(Function function) const {
+    for (int i = 0; i < width * height; i++)
+        if (data[i])
+            function(i);
+}
+
+inline void Bitmap::fill(bool value) {
+    std::memset(data, value, rawSize());
+}
+
+inline void Bitmap::invert() {
+    for (int i = 0; i < width * height; i++)
+        data[i] = !data[i];
+}
+
+inline Bitmap& Bitmap::operator&=(const Bitmap& bitmap) {
+    checkSize(bitmap);
+    for (int i = 0; i < width * height; i++)
+        data[i] &= bitmap.data[i];
+    return *this;
+}
+
+inline Bitmap& Bitmap::operator|=(const Bitmap& bitmap) {
+    checkSize(bitmap);
+    for (int i = 0; i < width * height; i++)
+        data[i] |= bitmap.data[i];
+    return *this;
 }
 
-Bitmap::Bitmap(int width, int height, bool defaultValue) : width(width), height(height) {
-    data = (bool**)std::malloc(height * sizeof(bool*));
-    if (height > 0) {
-        bool* firstRow = (bool*)std::malloc(width * sizeof(bool));
-        for (int x = 0; x < width; x++)
-            firstRow[x] = defaultValue;
-        data[0] = firstRow;
+inline Bitmap& Bitmap::andNot(const Bitmap& bitmap) {
+    checkSize(bitmap);
+    for (int i = 0; i < width * height; i++)
+        data[i] &= !bitmap.data[i];
+    return *this;
+}
+
+inline bool Bitmap::operator==(const Bitmap& bitmap) const {
+    return bitmap.width == width && bitmap.height == height && std::memcmp(data, bitmap.data, rawSize()) == 0;
+}
+
+inline void Bitmap::shift(int dx, int dy) {
+    if (dx >= width || -dx >= width || dy >= height || -dy >= height) {
+        fill(false);
+        return;
+    }
+
+    // a cell moves by dy * width + dx in the cell order, so it's one memmove and clearing what was moved in
+    int cells = width * height;
+    int offset = dy * width + dx;
+    if (offset > 0) {
+        std::memmove(data + offset, data, cells - offset);
+        std::memset(data, false, offset);
     }
-    for (int y = 1; y < height; y++) {
-        bool* row = (bool*)std::malloc(width * sizeof(bool));
-        std::copy(data[0], data[0] + width, row);
-        data[y] = row;
+    else if (offset < 0) {
+        std::memmove(data, data - offset, cells + offset);
+        std::memset(data + cells + offset, false, -offset);
     }
-}
 
-Bitmap::~Bitmap() {
-    if (data != nullptr) {
-        for (int y = 0; y < height; y++)
-            std::free(data[y]);
-        std::free(data);
+    // the cells that went over the left or right edge ended up in the row next to them
+    for (int y = 0; y < height && dx != 0; y++) {
+        if (dx > 0)
+            std::memset(data + y * stride, false, dx);
+        else
+            std::memset(data + y * stride + width + dx, false, -dx);
     }
 }
 
-bool Bitmap::get(int x, int y) {
-    return data[y][x];
+inline size_t Bitmap::rawSize() const {
+    return height * stride * sizeof(bool);
+}
+
+inline void Bitmap::copyTo(uint8_t* dest) const {
+    std::memcpy(dest, data, rawSize());
+}
+
+inline void Bitmap::copyFrom(const uint8_t* src) {
+    std::memcpy(data, src, rawSize());
+}
+
+inline void Bitmap::copyFrom(const Bitmap& bitmap) {
+    checkSize(bitmap);
+    std::memcpy(data, bitmap.data, rawSize());
 }
 
-void Bitmap::set(int x, int y, bool value) {
-    data[y][x] = value;
+inline void Bitmap::checkSize(const Bitmap& bitmap) const {
+    if (bitmap.width != width || bitmap.height != height)
+        throw std::invalid_argument("Bitmaps have different sizes!");
 }
 
 #ifdef INCLUDE_STB_IMAGE_WRITE_H
@@ -80,22 +270,22 @@ void Bitmap::set(int x, int y, bool value) {
         uint8_t* img = (uint8_t*)std::malloc(width * height);
         for (int y = 0; y < height; y++)
             for (int x = 0; x < width; x++)
-                img[y * width + x] = data[y][x] * 255;
+                img[y * width + x] = data[y * stride + x] * 255;
         stbi_write_bmp(filepath, width, height, 1, img);
         std::free(img);
     }
 #endif
 
-bool* Bitmap::operator[](int y) {
+inline bool* Bitmap::operator[](int y) {
     if (y >= height || y < 0)
         throw std::invalid_argument("index out of range!");
-    return data[y];
+    return data + y * stride;
 }
 
-std::ostream& operator<<(std::ostream& os, Bitmap bitmap) {
+inline std::ostream& operator<<(std::ostream& os, const Bitmap& bitmap) {
     for (int y = 0; y < bitmap.height; y++) {
         for (int x = 0; x < bitmap.width; x++)
-            os << (bitmap.data[y][x] ? '#' : '-');
+            os << (bitmap.get(x, y) ? '#' : '-');
         os << std::endl;
     }
     return os;
@@ -0,0 +1,149 @@
+#pragma once
+
+#ifndef _FIXED_BOARD_H_
+#define _FIXED_BOARD_H_
+
+#include <array>
+#include <stdint.h>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+// a W x H field (up to 64 cells) as a 64 bit board where the size is known at compile time
+// the neighbor table and the border masks are constexpr and the flood fill shifts by constants,
+// so the compiler can unroll everything that depends on the size (one instantiation per size)
+// the movement directions are the 4 straight ones (up, right, down, left)
+
+// ----------------------------------------------------------------------------------------------------
+// FixedBoard class
+// ----------------------------------------------------------------------------------------------------
+
+template<int W, int H>
+class FixedBoard {
+public:
+    static_assert(W > 0 && H > 0 && W * H <= 64, "a FixedBoard has to fit into 64 bits");
+
+    static constexpr int cells = W * H;
+    static constexpr int maxNeighbors = 4;
+
+    static constexpr uint64_t bit(int cell) {
+        return (uint64_t)1 << cell;
+    }
+
+    struct Neighbors {
+        int count = 0;
+        int cells[maxNeighbors] = {};
+    };
+
+    // (these have to come before the tables they build)
+    static constexpr uint64_t columnMask(int x) {
+        uint64_t mask = 0;
+        for (int y = 0; y < H; y++)
+            mask |= bit(y * W + x);
+        return mask;
+    }
+    static constexpr std::array<Neighbors, cells> makeNeighbors() {
+        std::array<Neighbors, cells> result = {};
+        for (int cell = 0; cell < cells; cell++) {
+            int x = cell % W, y = cell / W;
+            if (y > 0) result[cell].cells[result[cell].count++] = cell - W;
+            if (x < W - 1) result[cell].cells[result[cell].count++] = cell + 1;
+            if (y < H - 1) result[cell].cells[result[cell].count++] = cell + W;
+            if (x > 0) result[cell].cells[result[cell].count++] = cell - 1;
+        }
+        return result;
+    }
+
+    static constexpr uint64_t full = cells == 64 ? ~(uint64_t)0 : ((uint64_t)1 << cells) - 1;
+    static constexpr uint64_t firstColumn = columnMask(0);
+    static constexpr uint64_t lastColumn = columnMask(W - 1);
+    static constexpr uint64_t hasLeft = full & ~firstColumn; // the cells that have a neighbor to the left
+    static constexpr uint64_t hasRight = full & ~lastColumn;
+    static constexpr std::array<Neighbors, cells> neighbors = makeNeighbors();
+
+    static uint64_t grow(uint64_t fill) { // fill and all its neighbors
+        return (fill | ((fill & hasLeft) >> 1) | ((fill & hasRight) << 1) | (fill >> W) | (fill << W)) & full;
+    }
+    static bool connected(uint64_t board); // if the free cells of the board are all connected
+
+    // checks the neighbors of cell as children of the board, bit i of the result is set if neighbors[cell].cells[i] is free and its child is connected
+    // bit i of occupiedChildren is set if neighbors[cell].cells[i] is already occupied
+    static uint32_t evaluate(uint64_t board, int cell, uint32_t& occupiedChildren);
+
+private:
+#if defined(__AVX2__)
+    static uint32_t connected4(__m256i boards); // bit i is set if lane i is connected
+#endif
+};
+
+// ----------------------------------------------------------------------------------------------------
+// Implementation
+// ----------------------------------------------------------------------------------------------------
+
+template<int W, int H>
+bool FixedBoard<W, H>::connected(uint64_t board) {
+    uint64_t free = full & ~board;
+    uint64_t fill = free & (~free + 1); // the first free cell
+    while (true) {
+        uint64_t next = grow(fill) & free;
+        if (next == fill)
+            return fill == free;
+        fill = next;
+    }
+}
+
+template<int W, int H>
+uint32_t FixedBoard<W, H>::evaluate(uint64_t board, int cell, uint32_t& occupiedChildren) {
+    const Neighbors& cellNeighbors = neighbors[cell];
+    uint64_t children[maxNeighbors];
+    occupiedChildren = 0;
+    int freeChildren = 0;
+    for (int i = 0; i < cellNeighbors.count; i++) {
+        children[i] = board | bit(cellNeighbors.cells[i]);
+        if (children[i] == board)
+            occupiedChildren |= 1u << i;
+        else
+            freeChildren++;
+    }
+
+    uint32_t connectedChildren = 0;
+#if defined(__AVX2__)
+    // a single free child isn't worth the lanes, otherwise occupied children and unused lanes get a full board which has nothing to fill
+    if (freeChildren > 1) {
+        uint64_t boards[4];
+        for (int i = 0; i < 4; i++)
+            boards[i] = i < cellNeighbors.count && !(occupiedChildren & (1u << i)) ? children[i] : full;
+        return connected4(_mm256_loadu_si256((const __m256i*)boards)) & ~occupiedChildren & ((1u << cellNeighbors.count) - 1);
+    }
+#endif
+    for (int i = 0; i < cellNeighbors.count && freeChildren > 0; i++)
+        if (!(occupiedChildren & (1u << i)) && connected(children[i]))
+            connectedChildren |= 1u << i;
+    return connectedChildren;
+}
+
+#if defined(__AVX2__)
+template<int W, int H>
+uint32_t FixedBoard<W, H>::connected4(__m256i boards) {
+    const __m256i fullLanes = _mm256_set1_epi64x((long long)full);
+    const __m256i hasLeftLanes = _mm256_set1_epi64x((long long)hasLeft);
+    const __m256i hasRightLanes = _mm256_set1_epi64x((long long)hasRight);
+    __m256i free = _mm256_andnot_si256(boards, fullLanes);
+    __m256i fill = _mm256_and_si256(free, _mm256_sub_epi64(_mm256_setzero_si256(), free)); // the first free cell of every lane
+    while (true) {
+        __m256i next = _mm256_or_si256(fill, _mm256_srli_epi64(_mm256_and_si256(fill, hasLeftLanes), 1));
+        next = _mm256_or_si256(next, _mm256_slli_epi64(_mm256_and_si256(fill, hasRightLanes), 1));
+        next = _mm256_or_si256(next, _mm256_srli_epi64(fill, W));
+        next = _mm256_or_si256(next, _mm256_slli_epi64(fill, W));
+        next = _mm256_and_si256(next, free);
+        // stop once no lane grows anymore
+        if (_mm256_movemask_epi8(_mm256_cmpeq_epi64(next, fill)) == -1)
+            break;
+        fill = next;
+    }
+    return _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(fill, free)));
+}
+#endif
+
+#endif
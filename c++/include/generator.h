@@ -0,0 +1,99 @@
+#pragma once
+
+#ifndef _GENERATOR_H_
+#define _GENERATOR_H_
+
+// a coroutine that gives its values one at a time to a range based for loop, like std::generator of C++23
+// the coroutine only runs until its next co_yield when the loop wants the next value, so nothing is computed ahead or kept
+// around and a value that points into the coroutine (like a span of its path) is valid until the loop goes on
+// only there with C++20 coroutines (HAS_GENERATOR tells if it is)
+
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+#define HAS_GENERATOR true
+
+#include <coroutine>
+#include <exception>
+#include <iterator>
+#include <utility>
+
+// ----------------------------------------------------------------------------------------------------
+// Generator class
+// ----------------------------------------------------------------------------------------------------
+
+template<typename T>
+class Generator {
+public:
+    struct promise_type {
+        const T* current = nullptr; // the value of the last co_yield (it lives in the coroutine until it goes on)
+        std::exception_ptr exception;
+
+        Generator get_return_object() { return Generator(std::coroutine_handle<promise_type>::from_promise(*this)); }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        std::suspend_always yield_value(const T& value) noexcept {
+            current = &value;
+            return {};
+        }
+        void return_void() {}
+        void unhandled_exception() { exception = std::current_exception(); }
+    };
+
+    class Iterator {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+
+        Iterator() {}
+        explicit Iterator(std::coroutine_handle<promise_type> handle) : handle(handle) {}
+
+        const T& operator*() const { return *handle.promise().current; }
+        const T* operator->() const { return handle.promise().current; }
+        Iterator& operator++();
+        void operator++(int) { ++*this; }
+        bool operator==(std::default_sentinel_t) const { return !handle || handle.done(); }
+
+    private:
+        std::coroutine_handle<promise_type> handle;
+    };
+
+    explicit Generator(std::coroutine_handle<promise_type> handle) : handle(handle) {}
+    Generator(const Generator& generator) = delete;
+    Generator(Generator&& generator) noexcept : handle(std::exchange(generator.handle, {})) {}
+    ~Generator() {
+        if (handle)
+            handle.destroy();
+    }
+
+    Iterator begin(); // runs the coroutine to its first co_yield
+    std::default_sentinel_t end() { return {}; }
+
+private:
+    std::coroutine_handle<promise_type> handle;
+};
+
+// ----------------------------------------------------------------------------------------------------
+// Implementation
+// ----------------------------------------------------------------------------------------------------
+
+template<typename T>
+typename Generator<T>::Iterator& Generator<T>::Iterator::operator++() {
+    handle.resume();
+    if (handle.done() && handle.promise().exception)
+        std::rethrow_exception(handle.promise().exception);
+    return *this;
+}
+
+template<typename T>
+typename Generator<T>::Iterator Generator<T>::begin() {
+    Iterator iterator(handle);
+    if (handle)
+        ++iterator;
+    return iterator;
+}
+
+#else
+#define HAS_GENERATOR false
+#endif
+
+#endif
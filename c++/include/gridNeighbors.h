@@ -0,0 +1,31 @@
+#pragma once
+
+#ifndef _GRID_NEIGHBORS_H_
+#define _GRID_NEIGHBORS_H_
+
+#include <vector>
+
+// the 4 straight neighbors of every cell (y * width + x) of a width x height field for the searches that walk plain cell
+// indices (PathFinder, BackbiteSampler), up, right, down, left and -1 where that direction leaves the field
+// (the exhaustive search has its own NeighborTable in engine.h, which only lists the neighbors that exist)
+std::vector<int> gridNeighbors(int width, int height);
+
+// ----------------------------------------------------------------------------------------------------
+// Implementation
+// ----------------------------------------------------------------------------------------------------
+
+inline std::vector<int> gridNeighbors(int width, int height) {
+    std::vector<int> neighbors(width * height * 4, -1);
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            int cell = y * width + x;
+            if (y > 0) neighbors[cell * 4 + 0] = cell - width;
+            if (x < width - 1) neighbors[cell * 4 + 1] = cell + 1;
+            if (y < height - 1) neighbors[cell * 4 + 2] = cell + width;
+            if (x > 0) neighbors[cell * 4 + 3] = cell - 1;
+        }
+    }
+    return neighbors;
+}
+
+#endif
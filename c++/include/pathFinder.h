@@ -0,0 +1,257 @@
+#pragma once
+
+#ifndef _PATH_FINDER_H_
+#define _PATH_FINDER_H_
+
+#include <vector>
+#include <atomic>
+#include <algorithm>
+#include <stdint.h>
+
+#include "gridNeighbors.h"
+
+// searches for some paths that visit every cell of a width x height field (Hamiltonian paths) instead of all of them
+// the search is a depth first search in place (one path, the children of every depth are kept as a list of cells)
+// and stops as soon as the found callback says so or the shared cancelled flag is set (checked once per node, so it is cheap)
+// with warnsdorff the children are tried with the fewest free neighbors first, which walks along the border and into
+// corners before they get cut off, so the first path is found with almost no backtracking even on big fields
+// children that disconnect the free cells or leave more than one free cell with a single free neighbor (which has to be
+// the end of the path) are skipped, both is checked in constant time per node: the cells with a single free neighbor are
+// counted as the path moves and the free cells are only flood filled when the new head splits them around itself
+// the paths are 16 bit cell indices like the samples, so it works for fields up to 255 x 255
+
+// ----------------------------------------------------------------------------------------------------
+// PathFinder class
+// ----------------------------------------------------------------------------------------------------
+
+class PathFinder {
+public:
+    PathFinder(int width, int height, bool warnsdorff);
+    ~PathFinder() {}
+
+    int width, height;
+    int cells;
+    bool warnsdorff;
+
+    // the possible next cells after path (in the order they are tried)
+    std::vector<uint16_t> children(const std::vector<uint16_t>& path) const;
+    // the paths from start split into at least numItems prefixes (fewer if the field is too small), in the order they are tried
+    std::vector<std::vector<uint16_t>> split(int start, size_t numItems) const;
+
+    // searches the paths that begin with prefix and calls found(path) with the cells of every one (it returns false to stop)
+    // returns the number of nodes visited, stops early once cancelled is set
+    template<typename Found>
+    uint64_t search(const std::vector<uint16_t>& prefix, const std::atomic<bool>& cancelled, Found found) const;
+
+private:
+    std::vector<int> neighbors; // 4 per cell, -1 if that direction leaves the field
+
+    // the state of one search (every search has its own, so one PathFinder can be shared between threads)
+    struct State {
+        std::vector<uint16_t> path;
+        std::vector<uint8_t> occupied;
+        std::vector<uint8_t> freeNeighbors; // the number of free neighbors of every cell
+        int deadEnds = 0; // the free cells with at most one free neighbor
+        std::vector<uint32_t> visited; // visited[cell] == stamp if the current flood fill reached it
+        std::vector<uint16_t> fill; // the flood fill stack
+        uint32_t stamp = 0;
+    };
+
+    void setUp(State& state, const std::vector<uint16_t>& path) const; // the state after walking path
+    void occupy(State& state, int cell) const;
+    void release(State& state, int cell) const;
+    // if the free cells can still be walked from the last cell of the path, wasConnected if they were one area before it
+    bool promising(State& state, bool wasConnected) const;
+    bool connectedAround(const State& state, int cell) const; // if the free cells around cell are connected next to it
+    int orderChildren(const State& state, int cell, uint16_t* children) const; // returns the number of free neighbors
+};
+
+// ----------------------------------------------------------------------------------------------------
+// Implementation
+// ----------------------------------------------------------------------------------------------------
+
+inline PathFinder::PathFinder(int width, int height, bool warnsdorff) : width(width), height(height), cells(width * height), warnsdorff(warnsdorff),
+        neighbors(gridNeighbors(width, height)) {}
+
+inline std::vector<uint16_t> PathFinder::children(const std::vector<uint16_t>& path) const {
+    State state;
+    setUp(state, path);
+    uint16_t result[4];
+    int count = orderChildren(state, path.back(), result);
+    return std::vector<uint16_t>(result, result + count);
+}
+
+inline std::vector<std::vector<uint16_t>> PathFinder::split(int start, size_t numItems) const {
+    std::vector<std::vector<uint16_t>> items = {{(uint16_t)start}};
+    // the first item is split until there are enough, its children take its place so the order stays the one of the search
+    for (size_t first = 0; first < items.size() && items.size() < numItems;) {
+        if (items[first].size() + 1 >= cells) {
+            first++;
+            continue;
+        }
+        std::vector<uint16_t> prefix = items[first];
+        std::vector<uint16_t> next = children(prefix);
+        items.erase(items.begin() + first);
+        for (int i = 0; i < next.size(); i++) {
+            items.insert(items.begin() + first + i, prefix);
+            items[first + i].push_back(next[i]);
+        }
+    }
+    return items;
+}
+
+template<typename Found>
+uint64_t PathFinder::search(const std::vector<uint16_t>& prefix, const std::atomic<bool>& cancelled, Found found) const {
+    State state;
+    setUp(state, prefix);
+    if (prefix.size() == cells) {
+        found(state.path.data());
+        return 1;
+    }
+    if (!promising(state, false))
+        return 1;
+
+    int startLength = prefix.size();
+    std::vector<uint16_t> children(cells * 4); // children[length * 4 + i] are the children of the node with that path length
+    std::vector<uint8_t> numChildren(cells + 1), nextChild(cells + 1);
+    numChildren[startLength] = orderChildren(state, state.path.back(), &children[startLength * 4]);
+    nextChild[startLength] = 0;
+    uint64_t nodes = 1;
+
+    while (!cancelled.load(std::memory_order_relaxed)) {
+        int length = state.path.size();
+        if (nextChild[length] == numChildren[length]) { // back to the parent
+            if (length == startLength)
+                break;
+            release(state, state.path.back());
+            state.path.pop_back();
+            continue;
+        }
+        int child = children[length * 4 + nextChild[length]++];
+        state.path.push_back(child);
+        occupy(state, child);
+        nodes++;
+        if (length + 1 == cells) {
+            bool keepGoing = found(state.path.data());
+            release(state, child);
+            state.path.pop_back();
+            if (!keepGoing)
+                break;
+            continue;
+        }
+        if (!promising(state, true)) {
+            release(state, child);
+            state.path.pop_back();
+            continue;
+        }
+        numChildren[length + 1] = orderChildren(state, child, &children[(length + 1) * 4]);
+        nextChild[length + 1] = 0;
+    }
+    return nodes;
+}
+
+inline void PathFinder::setUp(State& state, const std::vector<uint16_t>& path) const {
+    state.occupied.assign(cells, 0);
+    state.freeNeighbors.assign(cells, 0);
+    state.visited.assign(cells, 0);
+    state.fill.reserve(cells);
+    state.deadEnds = 0;
+    for (int cell = 0; cell < cells; cell++) {
+        for (int dir = 0; dir < 4; dir++)
+            state.freeNeighbors[cell] += neighbors[cell * 4 + dir] >= 0;
+        state.deadEnds += state.freeNeighbors[cell] <= 1;
+    }
+    for (int i = 0; i < path.size(); i++) {
+        state.path.push_back(path[i]);
+        occupy(state, path[i]);
+    }
+}
+
+inline void PathFinder::occupy(State& state, int cell) const {
+    state.occupied[cell] = 1;
+    state.deadEnds -= state.freeNeighbors[cell] <= 1;
+    for (int dir = 0; dir < 4; dir++) {
+        int neighbor = neighbors[cell * 4 + dir];
+        if (neighbor >= 0 && --state.freeNeighbors[neighbor] == 1 && !state.occupied[neighbor])
+            state.deadEnds++;
+    }
+}
+
+inline void PathFinder::release(State& state, int cell) const {
+    state.occupied[cell] = 0;
+    state.deadEnds += state.freeNeighbors[cell] <= 1;
+    for (int dir = 0; dir < 4; dir++) {
+        int neighbor = neighbors[cell * 4 + dir];
+        if (neighbor >= 0 && ++state.freeNeighbors[neighbor] == 2 && !state.occupied[neighbor])
+            state.deadEnds--;
+    }
+}
+
+inline bool PathFinder::promising(State& state, bool wasConnected) const {
+    int head = state.path.back();
+    int freeCells = cells - state.path.size();
+    int first = -1;
+    int ends = state.deadEnds; // only the end of the path can have a single free neighbor
+    for (int dir = 0; dir < 4; dir++) {
+        int neighbor = neighbors[head * 4 + dir];
+        if (neighbor < 0 || state.occupied[neighbor])
+            continue;
+        if (first < 0)
+            first = neighbor;
+        ends -= state.freeNeighbors[neighbor] <= 1; // the neighbors of the head don't count, one of them is the next cell
+    }
+    if (first < 0)
+        return freeCells == 0;
+    if (ends > 1)
+        return false;
+    // the head can only split the free cells if they aren't connected around it, only then every free cell has to be reached
+    if (wasConnected && connectedAround(state, head))
+        return true;
+    state.stamp++;
+    state.visited[first] = state.stamp;
+    state.fill.push_back(first);
+    int reached = 0;
+    while (!state.fill.empty()) {
+        int cell = state.fill.back();
+        state.fill.pop_back();
+        reached++;
+        for (int dir = 0; dir < 4; dir++) {
+            int neighbor = neighbors[cell * 4 + dir];
+            if (neighbor >= 0 && !state.occupied[neighbor] && state.visited[neighbor] != state.stamp) {
+                state.visited[neighbor] = state.stamp;
+                state.fill.push_back(neighbor);
+            }
+        }
+    }
+    return reached == freeCells;
+}
+
+inline bool PathFinder::connectedAround(const State& state, int cell) const {
+    // the 8 cells around cell in a ring, the straight neighbors at the even positions
+    static const int ring[8][2] = {{0, -1}, {1, -1}, {1, 0}, {1, 1}, {0, 1}, {-1, 1}, {-1, 0}, {-1, -1}};
+    int x = cell % width, y = cell / width;
+    bool free[8];
+    for (int i = 0; i < 8; i++) {
+        int ringX = x + ring[i][0], ringY = y + ring[i][1];
+        free[i] = ringX >= 0 && ringX < width && ringY >= 0 && ringY < height && !state.occupied[ringY * width + ringX];
+    }
+    // two free straight neighbors are connected next to cell if the diagonal cell between them is free
+    int straight = 0, links = 0;
+    for (int i = 0; i < 8; i += 2) {
+        straight += free[i];
+        links += free[i] && free[i + 1] && free[(i + 2) % 8];
+    }
+    return straight - links <= 1;
+}
+
+inline int PathFinder::orderChildren(const State& state, int cell, uint16_t* children) const {
+    int count = 0;
+    for (int dir = 0; dir < 4; dir++)
+        if (neighbors[cell * 4 + dir] >= 0 && !state.occupied[neighbors[cell * 4 + dir]])
+            children[count++] = neighbors[cell * 4 + dir];
+    if (warnsdorff)
+        std::stable_sort(children, children + count, [&](uint16_t a, uint16_t b) { return state.freeNeighbors[a] < state.freeNeighbors[b]; });
+    return count;
+}
+
+#endif
@@ -0,0 +1,198 @@
+#pragma once
+
+#ifndef _PATH_RENDERER_H_
+#define _PATH_RENDERER_H_
+
+#include <vector>
+#include <string>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdint.h>
+
+// draws paths as line images (a dot on every cell, a line between every two cells after each other in the path)
+// the color goes from startColor at the first cell to endColor at the last cell
+// many paths are rendered in parallel, either into one png each or into tiles of a single atlas png
+// every thread draws straight into its own image (or its tiles of the atlas), so nothing is allocated per path or pixel row
+// (stb_image_write.h has to be included before this, like for the Bitmap)
+
+// ----------------------------------------------------------------------------------------------------
+// RenderOptions struct
+// ----------------------------------------------------------------------------------------------------
+
+struct RenderOptions {
+    int scale = 32; // pixels between two cells (the image has a margin of one scale around the field)
+    float dotRadius = 0.2f; // relative to scale
+    float lineWidth = 0.05f; // relative to scale
+    uint8_t startColor[3] = {0x20, 0x40, 0xc0};
+    uint8_t endColor[3] = {0xe0, 0x40, 0x20};
+    uint8_t backgroundColor[3] = {0xff, 0xff, 0xff};
+};
+
+// ----------------------------------------------------------------------------------------------------
+// PathRenderer class
+// ----------------------------------------------------------------------------------------------------
+
+class PathRenderer {
+public:
+    PathRenderer(int fieldWidth, int fieldHeight, RenderOptions options);
+    ~PathRenderer() {}
+
+    int fieldWidth, fieldHeight;
+    int imageWidth, imageHeight;
+    RenderOptions options;
+
+    // draws the path (cell indices y * fieldWidth + x, fieldWidth * fieldHeight of them) into an rgb image
+    // rowStride is the distance between two pixel rows in bytes, so it can draw into a tile of a bigger image
+    template<typename CellType>
+    void render(const CellType* path, uint8_t* pixels, size_t rowStride) const;
+
+    // renders count paths (getPath(i) returns the i-th) with numThreads threads into filePrefix<i>.png
+    template<typename GetPath>
+    bool renderFiles(size_t count, GetPath getPath, const std::string& filePrefix, int numThreads) const;
+    // renders count paths into tiles of one png (as square as possible)
+    template<typename GetPath>
+    bool renderAtlas(size_t count, GetPath getPath, const std::string& filepath, int numThreads) const;
+
+private:
+    void fillBackground(uint8_t* pixels, size_t rowStride) const;
+    void drawLine(uint8_t* pixels, size_t rowStride, float x0, float y0, float x1, float y1, float radius, const uint8_t* color) const;
+    void colorAt(int step, uint8_t* color) const;
+};
+
+// writes a columns x rows grid of values as squares of options.scale pixels, colored from startColor (minValue) to endColor (maxValue)
+bool writeHeatmap(const std::string& filepath, int columns, int rows, const double* values, double minValue, double maxValue, const RenderOptions& options);
+
+// ----------------------------------------------------------------------------------------------------
+// Implementation
+// ----------------------------------------------------------------------------------------------------
+
+inline PathRenderer::PathRenderer(int fieldWidth, int fieldHeight, RenderOptions options) : fieldWidth(fieldWidth), fieldHeight(fieldHeight),
+        imageWidth((fieldWidth + 1) * options.scale), imageHeight((fieldHeight + 1) * options.scale), options(options) {}
+
+template<typename CellType>
+void PathRenderer::render(const CellType* path, uint8_t* pixels, size_t rowStride) const {
+    fillBackground(pixels, rowStride);
+    int cells = fieldWidth * fieldHeight;
+    float scale = (float)options.scale;
+    uint8_t color[3];
+
+    // a line is a capsule, so drawing a zero length one is a dot
+    for (int i = 0; i + 1 < cells; i++) {
+        colorAt(i, color);
+        drawLine(pixels, rowStride, (path[i] % fieldWidth + 1) * scale, (path[i] / fieldWidth + 1) * scale,
+            (path[i + 1] % fieldWidth + 1) * scale, (path[i + 1] / fieldWidth + 1) * scale, options.lineWidth * scale / 2, color);
+    }
+    for (int i = 0; i < cells; i++) {
+        colorAt(i, color);
+        float x = (path[i] % fieldWidth + 1) * scale;
+        float y = (path[i] / fieldWidth + 1) * scale;
+        drawLine(pixels, rowStride, x, y, x, y, options.dotRadius * scale, color);
+    }
+}
+
+template<typename GetPath>
+bool PathRenderer::renderFiles(size_t count, GetPath getPath, const std::string& filePrefix, int numThreads) const {
+    std::atomic<size_t> next(0);
+    std::atomic<bool> ok(true);
+    std::vector<std::thread> threads(std::max(numThreads, 1));
+    for (int thread = 0; thread < threads.size(); thread++) {
+        threads[thread] = std::thread([&]() {
+            std::vector<uint8_t> pixels((size_t)imageWidth * imageHeight * 3);
+            for (size_t i = next++; i < count; i = next++) {
+                render(getPath(i), pixels.data(), (size_t)imageWidth * 3);
+                std::string filepath = filePrefix + std::to_string(i) + ".png";
+                if (!stbi_write_png(filepath.c_str(), imageWidth, imageHeight, 3, pixels.data(), imageWidth * 3))
+                    ok = false;
+            }
+        });
+    }
+    for (int thread = 0; thread < threads.size(); thread++)
+        threads[thread].join();
+    return ok;
+}
+
+template<typename GetPath>
+bool PathRenderer::renderAtlas(size_t count, GetPath getPath, const std::string& filepath, int numThreads) const {
+    if (count == 0)
+        return false;
+    size_t columns = (size_t)std::ceil(std::sqrt((double)count));
+    size_t rows = (count + columns - 1) / columns;
+    size_t rowStride = columns * imageWidth * 3;
+    std::vector<uint8_t> atlas(rowStride * rows * imageHeight);
+    for (size_t i = 0; i < atlas.size(); i += 3)
+        std::memcpy(atlas.data() + i, options.backgroundColor, 3);
+
+    std::atomic<size_t> next(0);
+    std::vector<std::thread> threads(std::max(numThreads, 1));
+    for (int thread = 0; thread < threads.size(); thread++) {
+        threads[thread] = std::thread([&]() {
+            for (size_t i = next++; i < count; i = next++) {
+                uint8_t* tile = atlas.data() + (i / columns) * imageHeight * rowStride + (i % columns) * imageWidth * 3;
+                render(getPath(i), tile, rowStride);
+            }
+        });
+    }
+    for (int thread = 0; thread < threads.size(); thread++)
+        threads[thread].join();
+    return stbi_write_png(filepath.c_str(), (int)(columns * imageWidth), (int)(rows * imageHeight), 3, atlas.data(), (int)rowStride) != 0;
+}
+
+inline void PathRenderer::fillBackground(uint8_t* pixels, size_t rowStride) const {
+    for (int x = 0; x < imageWidth; x++)
+        std::memcpy(pixels + x * 3, options.backgroundColor, 3);
+    for (int y = 1; y < imageHeight; y++)
+        std::memcpy(pixels + y * rowStride, pixels, imageWidth * 3);
+}
+
+inline void PathRenderer::drawLine(uint8_t* pixels, size_t rowStride, float x0, float y0, float x1, float y1, float radius, const uint8_t* color) const {
+    int minX = std::max((int)std::floor(std::min(x0, x1) - radius), 0);
+    int maxX = std::min((int)std::ceil(std::max(x0, x1) + radius), imageWidth - 1);
+    int minY = std::max((int)std::floor(std::min(y0, y1) - radius), 0);
+    int maxY = std::min((int)std::ceil(std::max(y0, y1) + radius), imageHeight - 1);
+    float dx = x1 - x0, dy = y1 - y0;
+    float lengthSquared = dx * dx + dy * dy;
+
+    // every pixel (at its center) closer than radius to the segment gets colored
+    for (int y = minY; y <= maxY; y++) {
+        uint8_t* row = pixels + y * rowStride;
+        for (int x = minX; x <= maxX; x++) {
+            float px = x + 0.5f - x0, py = y + 0.5f - y0;
+            float t = lengthSquared > 0 ? std::clamp((px * dx + py * dy) / lengthSquared, 0.0f, 1.0f) : 0;
+            float distX = px - t * dx, distY = py - t * dy;
+            if (distX * distX + distY * distY <= radius * radius)
+                std::memcpy(row + x * 3, color, 3);
+        }
+    }
+}
+
+inline void PathRenderer::colorAt(int step, uint8_t* color) const {
+    int cells = fieldWidth * fieldHeight;
+    float t = cells > 1 ? (float)step / (cells - 1) : 0;
+    for (int channel = 0; channel < 3; channel++)
+        color[channel] = (uint8_t)std::lround(options.startColor[channel] + t * (options.endColor[channel] - options.startColor[channel]));
+}
+
+inline bool writeHeatmap(const std::string& filepath, int columns, int rows, const double* values, double minValue, double maxValue, const RenderOptions& options) {
+    int imageWidth = columns * options.scale;
+    std::vector<uint8_t> pixels((size_t)imageWidth * rows * options.scale * 3);
+    for (int row = 0; row < rows; row++) {
+        uint8_t* firstLine = pixels.data() + (size_t)row * options.scale * imageWidth * 3;
+        for (int column = 0; column < columns; column++) {
+            double t = maxValue > minValue ? std::clamp((values[row * columns + column] - minValue) / (maxValue - minValue), 0.0, 1.0) : 0;
+            uint8_t color[3];
+            for (int channel = 0; channel < 3; channel++)
+                color[channel] = (uint8_t)std::lround(options.startColor[channel] + t * (options.endColor[channel] - options.startColor[channel]));
+            for (int x = 0; x < options.scale; x++)
+                std::memcpy(firstLine + (column * options.scale + x) * 3, color, 3);
+        }
+        // the other lines of the row are the same
+        for (int y = 1; y < options.scale; y++)
+            std::memcpy(firstLine + (size_t)y * imageWidth * 3, firstLine, imageWidth * 3);
+    }
+    return stbi_write_png(filepath.c_str(), imageWidth, rows * options.scale, 3, pixels.data(), imageWidth * 3) != 0;
+}
+
+#endif
@@ -0,0 +1,124 @@
+#pragma once
+
+#ifndef _PROGRESS_H_
+#define _PROGRESS_H_
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <algorithm>
+#include <stdint.h>
+
+// progress of a run that is split into work items, shared between the solving threads and a reporter thread
+// every work item comes with an estimate of its number of nodes, the ETA is the estimated remaining nodes divided by the node rate
+// the estimates get corrected by how far off they were for the work items that already finished
+
+// ----------------------------------------------------------------------------------------------------
+// Progress class
+// ----------------------------------------------------------------------------------------------------
+
+class Progress {
+public:
+    Progress(std::vector<double> estimates);
+    Progress(const Progress& progress) = delete;
+    ~Progress() {}
+
+    std::vector<double> estimates; // the estimated number of nodes of each work item
+    double totalEstimate = 0;
+
+    std::atomic<uint64_t> nodes{0}; // the threads add their nodes every few thousand nodes
+
+    void addNodes(uint64_t amount) {
+        nodes.fetch_add(amount, std::memory_order_relaxed);
+    }
+    void finishItem(int item, uint64_t itemNodes); // itemNodes are the nodes the work item actually had (item is -1 for a part of one)
+
+    void report(std::ostream& os); // prints one progress line
+    void run(std::ostream& os, double intervalSeconds); // reports every interval until stop is called
+    void stop();
+
+    static std::string formatDuration(double seconds);
+
+private:
+    std::mutex mutex;
+    std::condition_variable stopped;
+    bool running = true;
+
+    std::chrono::high_resolution_clock::time_point startTime;
+    int itemsDone = 0;
+    double doneEstimate = 0; // the estimates of the finished work items
+    uint64_t doneNodes = 0; // the real nodes of the finished work items
+};
+
+// ----------------------------------------------------------------------------------------------------
+// Implementation
+// ----------------------------------------------------------------------------------------------------
+
+inline Progress::Progress(std::vector<double> estimates) : estimates(estimates), startTime(std::chrono::high_resolution_clock::now()) {
+    for (int i = 0; i < this->estimates.size(); i++)
+        totalEstimate += this->estimates[i];
+}
+
+inline void Progress::finishItem(int item, uint64_t itemNodes) {
+    std::lock_guard<std::mutex> lock(mutex);
+    // a part that was split off while solving is in the estimate of its item, so it only adds its nodes
+    if (item >= 0) {
+        itemsDone++;
+        doneEstimate += estimates[item];
+    }
+    doneNodes += itemNodes;
+}
+
+inline void Progress::report(std::ostream& os) {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - startTime;
+    uint64_t currNodes = nodes.load(std::memory_order_relaxed);
+    double nodesPerSecond = elapsed.count() > 0 ? currNodes / elapsed.count() : 0;
+
+    // the finished items show how far off the estimates are, the unfinished ones are scaled by that
+    double correction = doneEstimate > 0 ? doneNodes / doneEstimate : 1;
+    double remaining = (totalEstimate - doneEstimate) * correction - (double)(currNodes - std::min(currNodes, doneNodes));
+    if (remaining < 0)
+        remaining = 0;
+
+    os << "progress: " << itemsDone << "/" << estimates.size() << " work items, " << currNodes << " nodes, "
+       << (uint64_t)nodesPerSecond << " nodes/s, eta " << (nodesPerSecond > 0 ? formatDuration(remaining / nodesPerSecond) : "unknown") << std::endl;
+}
+
+inline void Progress::run(std::ostream& os, double intervalSeconds) {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (running) {
+        stopped.wait_for(lock, std::chrono::duration<double>(intervalSeconds));
+        if (!running)
+            break;
+        lock.unlock();
+        report(os);
+        lock.lock();
+    }
+}
+
+inline void Progress::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        running = false;
+    }
+    stopped.notify_all();
+}
+
+inline std::string Progress::formatDuration(double seconds) {
+    uint64_t total = (uint64_t)seconds;
+    std::string result;
+    if (total >= 86400)
+        result += std::to_string(total / 86400) + "d ";
+    if (total >= 3600)
+        result += std::to_string(total / 3600 % 24) + "h ";
+    if (total >= 60)
+        result += std::to_string(total / 60 % 60) + "m ";
+    return result + std::to_string(total % 60) + "s";
+}
+
+#endif
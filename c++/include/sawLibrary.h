@@ -0,0 +1,44 @@
+#pragma once
+
+#ifndef _SAW_LIBRARY_H_
+#define _SAW_LIBRARY_H_
+
+#include <stdint.h>
+
+// the C interface of the search as a shared library (library.cpp), so other languages can call it (python/main.py with ctypes)
+// paths are written as width * height 16 bit cell indices (y * width + x) in walking order, back to back into the buffer of
+// the caller, so nothing is allocated for the caller and nothing has to be freed
+// every function returns -1 if the arguments don't work (a size below 1, more than 65535 cells or a start off the field)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// the number of paths that visit every cell, from start (y * width + x) or from every cell if start is -1
+// (like main, a path needs at least one step, so a 1x1 field has none)
+// numThreads 0 is one per hardware thread
+int64_t sawCount(int width, int height, int start, int numThreads);
+
+// writes up to maxPaths of those paths into buffer (maxPaths * width * height cells) and returns how many it wrote
+// with more than one thread the order (and with maxPaths below the count, which paths) depends on the timing
+int64_t sawEnumerate(int width, int height, int start, int numThreads, uint16_t* buffer, uint64_t maxPaths);
+
+// gets count paths (count * width * height cells) at a time from sawEnumerateBatches, they are only valid during the call
+// returns 0 to stop the search
+typedef int (*SawBatchCallback)(const uint16_t* paths, uint64_t count, void* userData);
+
+// gives every one of those paths to callback in batches of up to batchSize (0 for 4096) and returns how many it gave, so the
+// caller needs no buffer for all of them and the search runs only once (the callback is called by one thread at a time, but
+// with more than one thread not always the same one and the order depends on the timing)
+int64_t sawEnumerateBatches(int width, int height, int start, int numThreads, uint64_t batchSize, SawBatchCallback callback, void* userData);
+
+// writes numSamples random paths of one backbite chain into buffer (numSamples * width * height cells) and returns numSamples
+// burnIn and sampleSteps are the moves before the first and between two samples, 0 for the defaults of main
+// (10 * cells * the longer side and the number of cells)
+int64_t sawSample(int width, int height, uint64_t seed, uint64_t burnIn, uint64_t sampleSteps, uint16_t* buffer, uint64_t numSamples);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
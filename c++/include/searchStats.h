@@ -0,0 +1,149 @@
+#pragma once
+
+#ifndef _SEARCH_STATS_H_
+#define _SEARCH_STATS_H_
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <stdint.h>
+
+// counters of what the search did, broken down by starting cell and path depth
+// every thread has its own SearchStats and they are merged at the end, so counting is just an increment
+// the depth is the length of the path of the node that was expanded, the children it rejected are counted at its depth too
+
+// ----------------------------------------------------------------------------------------------------
+// SearchStats class
+// ----------------------------------------------------------------------------------------------------
+
+class SearchStats {
+public:
+    enum Counter {
+        NODES, // nodes expanded
+        OUT_OF_BOUNDS, // directions that would leave the field
+        OCCUPIED, // neighbors that were already walked on
+        DISCONNECTED, // children cut off by connected()
+        SOLUTIONS, // children that are solutions
+        NUM_COUNTERS
+    };
+
+    SearchStats(int fieldWidth, int fieldHeight);
+    ~SearchStats() {}
+
+    int fieldWidth, fieldHeight;
+    int cells;
+
+    void add(int start, int depth, Counter counter, uint64_t amount = 1) {
+        blocks[start * (cells + 1) + depth].counts[counter] += amount;
+    }
+    // counts one expanded node and what happened to its children
+    void addNode(int start, int depth, uint64_t outOfBounds, uint64_t occupied, uint64_t disconnected, uint64_t solutions) {
+        uint64_t* counts = blocks[start * (cells + 1) + depth].counts;
+        counts[NODES]++;
+        counts[OUT_OF_BOUNDS] += outOfBounds;
+        counts[OCCUPIED] += occupied;
+        counts[DISCONNECTED] += disconnected;
+        counts[SOLUTIONS] += solutions;
+    }
+    uint64_t get(int start, int depth, Counter counter) const {
+        return blocks[start * (cells + 1) + depth].counts[counter];
+    }
+    void merge(const SearchStats& stats);
+
+    void printSummary(std::ostream& os) const; // a table of the counters per depth
+    void writeJson(std::ostream& os) const;
+
+    static const char* counterName(Counter counter);
+
+private:
+    // the counters of one starting cell and depth, padded to a cache line so two threads never write the same line
+    struct alignas(64) Block {
+        uint64_t counts[NUM_COUNTERS] = {};
+    };
+
+    std::vector<Block> blocks; // blocks[start * (cells + 1) + depth]
+};
+
+// ----------------------------------------------------------------------------------------------------
+// Implementation
+// ----------------------------------------------------------------------------------------------------
+
+inline SearchStats::SearchStats(int fieldWidth, int fieldHeight) : fieldWidth(fieldWidth), fieldHeight(fieldHeight), cells(fieldWidth * fieldHeight),
+        blocks(fieldWidth * fieldHeight * (fieldWidth * fieldHeight + 1)) {}
+
+inline void SearchStats::merge(const SearchStats& stats) {
+    for (int i = 0; i < blocks.size(); i++)
+        for (int counter = 0; counter < NUM_COUNTERS; counter++)
+            blocks[i].counts[counter] += stats.blocks[i].counts[counter];
+}
+
+inline void SearchStats::printSummary(std::ostream& os) const {
+    const int columnWidth = 14;
+    os << std::setw(6) << "depth";
+    for (int counter = 0; counter < NUM_COUNTERS; counter++)
+        os << std::setw(columnWidth) << counterName((Counter)counter);
+    os << std::endl;
+
+    std::vector<uint64_t> totals(NUM_COUNTERS, 0);
+    for (int depth = 0; depth <= cells; depth++) {
+        std::vector<uint64_t> sums(NUM_COUNTERS, 0);
+        for (int start = 0; start < cells; start++)
+            for (int counter = 0; counter < NUM_COUNTERS; counter++)
+                sums[counter] += get(start, depth, (Counter)counter);
+        if (sums[NODES] == 0)
+            continue;
+        os << std::setw(6) << depth;
+        for (int counter = 0; counter < NUM_COUNTERS; counter++) {
+            os << std::setw(columnWidth) << sums[counter];
+            totals[counter] += sums[counter];
+        }
+        os << std::endl;
+    }
+
+    os << std::setw(6) << "total";
+    for (int counter = 0; counter < NUM_COUNTERS; counter++)
+        os << std::setw(columnWidth) << totals[counter];
+    os << std::endl;
+}
+
+inline void SearchStats::writeJson(std::ostream& os) const {
+    os << "{\n  \"width\": " << fieldWidth << ",\n  \"height\": " << fieldHeight << ",\n  \"counters\": [";
+    for (int counter = 0; counter < NUM_COUNTERS; counter++)
+        os << (counter > 0 ? ", " : "") << "\"" << counterName((Counter)counter) << "\"";
+    os << "],\n  \"starts\": [";
+
+    bool firstStart = true;
+    for (int start = 0; start < cells; start++) {
+        bool used = false;
+        for (int depth = 0; depth <= cells && !used; depth++)
+            used = get(start, depth, NODES) != 0;
+        if (!used)
+            continue;
+
+        os << (firstStart ? "\n" : ",\n") << "    {\"x\": " << start % fieldWidth << ", \"y\": " << start / fieldWidth << ", \"depths\": [";
+        firstStart = false;
+        // one array of all counters per depth (in the order of "counters")
+        for (int depth = 0; depth <= cells; depth++) {
+            os << (depth > 0 ? ", " : "") << "[";
+            for (int counter = 0; counter < NUM_COUNTERS; counter++)
+                os << (counter > 0 ? ", " : "") << get(start, depth, (Counter)counter);
+            os << "]";
+        }
+        os << "]}";
+    }
+    os << "\n  ]\n}\n";
+}
+
+inline const char* SearchStats::counterName(Counter counter) {
+    switch (counter) {
+        case NODES: return "nodes";
+        case OUT_OF_BOUNDS: return "outOfBounds";
+        case OCCUPIED: return "occupied";
+        case DISCONNECTED: return "disconnected";
+        case SOLUTIONS: return "solutions";
+        default: return "unknown";
+    }
+}
+
+#endif
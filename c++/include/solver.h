@@ -0,0 +1,308 @@
+#pragma once
+
+#ifndef _SOLVER_H_
+#define _SOLVER_H_
+
+#include <vector>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <algorithm>
+#include <type_traits>
+#include <stdint.h>
+
+#include "engine.h"
+#include "threadPool.h"
+#include "generator.h"
+#if HAS_GENERATOR
+#include <span>
+#endif
+
+// the search as a library: solve(field, options, visitor) calls the visitor with every path of the field, so a program can
+// count, filter or write the paths itself instead of reading the output files of main
+// it is the search of main (engine.h with its work items, the sizes compiled with SPECIALIZE_SIZES and the symmetries of the
+// SymmetryTable), the solutions just go to the visitor instead of into a SolveResult
+// every thread gets its own copy of the visitor (so it needs no locking) and at the end the copies are reduced into one in
+// the order of the threads, which is what solve returns
+// a path has at least one step like in main (a 1x1 field has none)
+// the visitor gets a PathView of the cell indices, it points into the search (nothing is copied) and is only valid during the call
+// solve starts its threads on every call unless options.pool is set, a program that solves many fields can keep one ThreadPool
+// for all of them (solve can't be called from a task of that pool, it waits for its own tasks on it)
+// with C++20 enumerate(field) gives the same paths to a for loop instead of a visitor
+
+// ----------------------------------------------------------------------------------------------------
+// PathView struct
+// ----------------------------------------------------------------------------------------------------
+
+// the cell indices of one path in walking order (like a std::span, which needs C++20)
+struct PathView {
+    const Cell* cells;
+    size_t length;
+
+    const Cell* begin() const { return cells; }
+    const Cell* end() const { return cells + length; }
+    size_t size() const { return length; }
+    Cell operator[](size_t i) const { return cells[i]; }
+    Cell start() const { return cells[0]; }
+    Cell last() const { return cells[length - 1]; }
+#if HAS_GENERATOR
+    operator std::span<const Cell>() const { return std::span<const Cell>(cells, length); }
+#endif
+};
+
+// ----------------------------------------------------------------------------------------------------
+// Field class
+// ----------------------------------------------------------------------------------------------------
+
+// a field with the 4 straight directions and the tables of the search, it can be solved any number of times
+class Field {
+public:
+    Field(int width, int height);
+    Field(const Field& field) = delete;
+    ~Field() {}
+
+    int width, height;
+    int cells;
+    std::vector<Pos> deltaDirections;
+    NeighborTable neighborTable;
+    SymmetryTable symmetryTable;
+};
+
+// ----------------------------------------------------------------------------------------------------
+// SolveOptions struct
+// ----------------------------------------------------------------------------------------------------
+
+struct SolveOptions {
+    int numThreads = 0; // 0 is one per hardware thread
+    bool symmetries = true; // searches only the canonical starting positions and visits the mirrored paths too
+    int start = -1; // only the paths from this cell (-1 for every start)
+    size_t itemsPerThread = 8; // the starting positions are split into about this many work items per thread
+    ThreadPool* pool = nullptr; // the threads solve runs on (then numThreads is the one of the pool), nullptr starts new ones
+};
+
+// ----------------------------------------------------------------------------------------------------
+// VisitorResult class
+// ----------------------------------------------------------------------------------------------------
+
+// the Result of the search (see engine.h) for one thread of solve, every solution and its mirrored variants go to the visitor
+// once the visitor returns false the work items are stopped, so every thread stops at its next node
+template<typename Visitor>
+class VisitorResult {
+public:
+    VisitorResult(Field& field, Visitor& visitor, const std::vector<std::vector<int>>& startTransforms, WorkItems& workItems);
+    ~VisitorResult() {}
+
+    uint64_t nodes = 0;
+#if COLLECT_STATS
+    SearchStats stats;
+#endif
+
+    void addSolution(const Cell* path);
+
+private:
+    Field& field;
+    Visitor& visitor;
+    const std::vector<std::vector<int>>& startTransforms; // the transforms of the SymmetryTable the paths of every start are mirrored with
+    WorkItems& workItems;
+    std::vector<Cell> variant; // the mirrored path
+    bool stopped = false; // the visitor returned false, the solutions the search still finds on its way out are dropped
+
+    bool visit(const Cell* path); // false if the visitor wants to stop
+};
+
+#if HAS_GENERATOR
+// ----------------------------------------------------------------------------------------------------
+// EndCells struct
+// ----------------------------------------------------------------------------------------------------
+
+// the Result of the search of enumerate, the solutions of one expand only differ in their last cell, so only that is kept
+// until the generator gives them out
+struct EndCells {
+    EndCells(int width, int height) : cells(width * height)
+#if COLLECT_STATS
+        , stats(width, height)
+#endif
+    {}
+
+    int cells;
+    std::vector<Cell> ends;
+    uint64_t nodes = 0;
+#if COLLECT_STATS
+    SearchStats stats;
+#endif
+
+    void addSolution(const Cell* path) {
+        ends.push_back(path[cells - 1]);
+    }
+};
+#endif
+
+// ----------------------------------------------------------------------------------------------------
+// solve functions
+// ----------------------------------------------------------------------------------------------------
+
+// visitor(PathView) is called with every path, if it returns a bool false stops the search (on every thread, the paths that were
+// already being visited on other threads still come), reduce(Visitor& into, Visitor& from) merges the copy of a thread into the result
+template<typename Visitor, typename Reduce>
+Visitor solve(Field& field, const SolveOptions& options, const Visitor& visitor, Reduce reduce);
+// the same with the visitor's reduce(Visitor& from) member as the reduce step
+template<typename Visitor>
+Visitor solve(Field& field, const SolveOptions& options, const Visitor& visitor);
+
+#if HAS_GENERATOR
+// every path of the field one at a time for a range based for loop: the search and the starts of solve (options.start and
+// options.symmetries, there are no other threads) on the thread of the loop, which only goes on when the loop wants the next path
+// every path is a view of the path of the search or of the variant of the generator, valid until the loop goes on
+// (the field has to outlive the loop)
+Generator<PathView> enumerate(Field& field, SolveOptions options = SolveOptions());
+#endif
+
+// the starting positions the options ask for and the transforms the paths of every start cell are mirrored with (the identity
+// first, none for the cells that aren't a starting position), on a field with an odd number of cells only the cells with the color
+// of the corners are starts (no solution starts on the other ones)
+std::deque<Candidate> searchStarts(Field& field, const SolveOptions& options, std::vector<std::vector<int>>& startTransforms);
+
+// ----------------------------------------------------------------------------------------------------
+// Implementation
+// ----------------------------------------------------------------------------------------------------
+
+inline Field::Field(int width, int height) : width(width), height(height), cells(width * height),
+        deltaDirections({Pos(0, -1), Pos(1, 0), Pos(0, 1), Pos(-1, 0)}), neighborTable(width, height, deltaDirections), symmetryTable(width, height) {}
+
+template<typename Visitor>
+VisitorResult<Visitor>::VisitorResult(Field& field, Visitor& visitor, const std::vector<std::vector<int>>& startTransforms, WorkItems& workItems) :
+#if COLLECT_STATS
+        stats(field.width, field.height),
+#endif
+        field(field), visitor(visitor), startTransforms(startTransforms), workItems(workItems), variant(field.cells) {}
+
+template<typename Visitor>
+void VisitorResult<Visitor>::addSolution(const Cell* path) {
+    if (stopped)
+        return;
+    const std::vector<int>& transforms = startTransforms[path[0]];
+    bool keepGoing = visit(path);
+    for (int i = 1; i < transforms.size() && keepGoing; i++) {
+        applyToEntirePath(path, variant.data(), field.symmetryTable.permutation(transforms[i]), field.cells);
+        keepGoing = visit(variant.data());
+    }
+    if (!keepGoing) {
+        stopped = true;
+        workItems.stop();
+    }
+}
+
+template<typename Visitor>
+bool VisitorResult<Visitor>::visit(const Cell* path) {
+    PathView view{path, (size_t)field.cells};
+    if constexpr (std::is_same_v<decltype(visitor(view)), bool>)
+        return visitor(view);
+    else {
+        visitor(view);
+        return true;
+    }
+}
+
+template<typename Visitor, typename Reduce>
+Visitor solve(Field& field, const SolveOptions& options, const Visitor& visitor, Reduce reduce) {
+    int numThreads = options.numThreads > 0 ? options.numThreads : std::max((int)std::thread::hardware_concurrency(), 1);
+    if (options.pool != nullptr)
+        numThreads = options.pool->numThreads;
+    std::vector<std::vector<int>> startTransforms;
+    std::deque<Candidate> startingPoses = searchStarts(field, options, startTransforms);
+
+    std::vector<Visitor> threadVisitors(numThreads, visitor);
+    WorkItems workItems(field.neighborTable, numThreads * options.itemsPerThread * 2);
+    {
+        // the solutions found while splitting go to the visitor of the first thread
+        VisitorResult<Visitor> splitResult(field, threadVisitors[0], startTransforms, workItems);
+        Bitmap toCheck(field.width, field.height);
+        splitStartingPoses(startingPoses, splitResult, field.neighborTable, toCheck, numThreads * options.itemsPerThread);
+    }
+    for (int i = startingPoses.size() - 1; i >= 0; i--)
+        workItems.add(startingPoses[i].path.data(), startingPoses[i].pathIndex, i);
+
+    SolveFunction<VisitorResult<Visitor>> solveFunction = solveItems<VisitorResult<Visitor>>;
+#if SPECIALIZE_SIZES
+    if (fixedSolve<VisitorResult<Visitor>>(field.width, field.height, field.deltaDirections) != nullptr)
+        solveFunction = fixedSolve<VisitorResult<Visitor>>(field.width, field.height, field.deltaDirections);
+#endif
+    {
+        std::unique_ptr<ThreadPool> ownPool;
+        ThreadPool* pool = options.pool;
+        if (pool == nullptr) {
+            ownPool = std::make_unique<ThreadPool>(numThreads);
+            pool = ownPool.get();
+        }
+        for (int task = 0; task < numThreads; task++) {
+            pool->submit([&](int thread) {
+                VisitorResult<Visitor> result(field, threadVisitors[thread], startTransforms, workItems);
+                solveFunction(field.width, field.height, &workItems, &result, &field.neighborTable, nullptr);
+            });
+        }
+        pool->wait();
+    }
+
+    Visitor result = std::move(threadVisitors[0]);
+    for (int thread = 1; thread < numThreads; thread++)
+        reduce(result, threadVisitors[thread]);
+    return result;
+}
+
+template<typename Visitor>
+Visitor solve(Field& field, const SolveOptions& options, const Visitor& visitor) {
+    return solve(field, options, visitor, [](Visitor& into, Visitor& from) { into.reduce(from); });
+}
+
+#if HAS_GENERATOR
+inline Generator<PathView> enumerate(Field& field, SolveOptions options) {
+    std::vector<std::vector<int>> startTransforms;
+    std::deque<Candidate> startingPoses = searchStarts(field, options, startTransforms);
+    Arena arena;
+    CandidateStack candidates(arena, field.width, field.height);
+    Candidate currCandidate(field.width, field.height);
+    Bitmap toCheck(field.width, field.height);
+    EndCells result(field.width, field.height);
+    std::vector<Cell> variant(field.cells);
+
+    for (const Candidate& start : startingPoses) {
+        const std::vector<int>& transforms = startTransforms[start.path[0]];
+        candidates.push_back(start);
+        while (!candidates.empty()) {
+            candidates.popInto(currCandidate);
+            result.ends.clear();
+            expand(candidates, result, field.neighborTable, currCandidate, toCheck);
+            result.nodes++;
+            for (Cell end : result.ends) {
+                currCandidate.path[field.cells - 1] = end;
+                co_yield PathView{currCandidate.path.data(), (size_t)field.cells};
+                for (int i = 1; i < transforms.size(); i++) {
+                    applyToEntirePath(currCandidate.path.data(), variant.data(), field.symmetryTable.permutation(transforms[i]), field.cells);
+                    co_yield PathView{variant.data(), (size_t)field.cells};
+                }
+            }
+        }
+    }
+}
+#endif
+
+inline std::deque<Candidate> searchStarts(Field& field, const SolveOptions& options, std::vector<std::vector<int>>& startTransforms) {
+    startTransforms.assign(field.cells, std::vector<int>());
+    std::deque<Candidate> startingPoses;
+    if (options.symmetries && options.start < 0) {
+        startingPoses = canonicalStartingPoses(field.width, field.height);
+        for (int i = 0; i < startingPoses.size(); i++)
+            startTransforms[startingPoses[i].path[0]] = field.symmetryTable.transformsOf(startingPoses[i].path[0]);
+        return startingPoses;
+    }
+    for (int cell = 0; cell < field.cells; cell++) {
+        if ((options.start >= 0 && cell != options.start) || (field.cells % 2 == 1 && (cell % field.width + cell / field.width) % 2 == 1))
+            continue;
+        Cell start = cell;
+        startingPoses.push_back(prefixCandidate(field.width, field.height, &start, 1));
+        startTransforms[cell] = {0};
+    }
+    return startingPoses;
+}
+
+#endif
@@ -0,0 +1,94 @@
+#pragma once
+
+#ifndef _THREAD_POOL_H_
+#define _THREAD_POOL_H_
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+// a fixed number of threads that stay alive and run tasks in the order they were submitted
+// every task gets the index of the thread that runs it, so it can use memory that belongs to that thread
+// (thread_local memory like an Arena stays alive between tasks too, so it is reused instead of reallocated)
+
+// ----------------------------------------------------------------------------------------------------
+// ThreadPool class
+// ----------------------------------------------------------------------------------------------------
+
+class ThreadPool {
+public:
+    ThreadPool(int numThreads);
+    ThreadPool(const ThreadPool& threadPool) = delete;
+    ~ThreadPool(); // finishes the submitted tasks and joins the threads
+
+    int numThreads;
+
+    void submit(std::function<void(int thread)> task);
+    void wait(); // blocks until every submitted task is done
+
+private:
+    std::vector<std::thread> threads;
+    std::deque<std::function<void(int thread)>> tasks;
+    std::mutex mutex;
+    std::condition_variable taskAdded;
+    std::condition_variable tasksDone;
+    int runningTasks = 0;
+    bool stopping = false;
+
+    void work(int thread);
+};
+
+// ----------------------------------------------------------------------------------------------------
+// Implementation
+// ----------------------------------------------------------------------------------------------------
+
+inline ThreadPool::ThreadPool(int numThreads) : numThreads(numThreads > 0 ? numThreads : 1) {
+    for (int thread = 0; thread < this->numThreads; thread++)
+        threads.emplace_back(&ThreadPool::work, this, thread);
+}
+
+inline ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    taskAdded.notify_all();
+    for (int thread = 0; thread < threads.size(); thread++)
+        threads[thread].join();
+}
+
+inline void ThreadPool::submit(std::function<void(int thread)> task) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        tasks.push_back(std::move(task));
+    }
+    taskAdded.notify_one();
+}
+
+inline void ThreadPool::wait() {
+    std::unique_lock<std::mutex> lock(mutex);
+    tasksDone.wait(lock, [this]() { return tasks.empty() && runningTasks == 0; });
+}
+
+inline void ThreadPool::work(int thread) {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        taskAdded.wait(lock, [this]() { return stopping || !tasks.empty(); });
+        if (tasks.empty()) // only when stopping
+            return;
+        std::function<void(int thread)> task = std::move(tasks.front());
+        tasks.pop_front();
+        runningTasks++;
+        lock.unlock();
+        task(thread);
+        lock.lock();
+        runningTasks--;
+        if (tasks.empty() && runningTasks == 0)
+            tasksDone.notify_all();
+    }
+}
+
+#endif
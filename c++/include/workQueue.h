@@ -0,0 +1,104 @@
+#pragma once
+
+#ifndef _WORK_QUEUE_H_
+#define _WORK_QUEUE_H_
+
+#include <atomic>
+#include <memory>
+#include <stdint.h>
+
+// a bounded lock free queue that any number of threads can push to and pop from at the same time
+// it's a ring of slots that each have a sequence number: a slot can be written when its sequence is the push position
+// and read when it is the push position + 1, so a thread claims a position with one compare exchange and only waits
+// for the slot it claimed (instead of everyone waiting for one mutex)
+// the items are copied in and out, so they should be small (a few bytes, not something that owns memory)
+
+// ----------------------------------------------------------------------------------------------------
+// WorkQueue class
+// ----------------------------------------------------------------------------------------------------
+
+template<typename T>
+class WorkQueue {
+public:
+    WorkQueue(size_t capacity); // rounded up to a power of two
+    WorkQueue(const WorkQueue& workQueue) = delete;
+    ~WorkQueue() {}
+
+    size_t capacity;
+
+    bool push(const T& item); // false if the queue is full
+    bool pop(T& item); // false if the queue is empty
+    bool empty() const { // only a hint while other threads push and pop
+        return pushPos.load(std::memory_order_relaxed) <= popPos.load(std::memory_order_relaxed);
+    }
+
+private:
+    struct Slot {
+        std::atomic<size_t> sequence;
+        T item;
+    };
+
+    std::unique_ptr<Slot[]> slots;
+    size_t mask;
+    // on their own cache lines, the pushing and the popping threads don't slow each other down
+    alignas(64) std::atomic<size_t> pushPos{0};
+    alignas(64) std::atomic<size_t> popPos{0};
+};
+
+// ----------------------------------------------------------------------------------------------------
+// Implementation
+// ----------------------------------------------------------------------------------------------------
+
+template<typename T>
+WorkQueue<T>::WorkQueue(size_t capacity) : capacity(1) {
+    while (this->capacity < capacity)
+        this->capacity *= 2;
+    mask = this->capacity - 1;
+    slots.reset(new Slot[this->capacity]);
+    for (size_t i = 0; i < this->capacity; i++)
+        slots[i].sequence.store(i, std::memory_order_relaxed);
+}
+
+template<typename T>
+bool WorkQueue<T>::push(const T& item) {
+    size_t pos = pushPos.load(std::memory_order_relaxed);
+    Slot* slot;
+    while (true) {
+        slot = &slots[pos & mask];
+        intptr_t diff = (intptr_t)slot->sequence.load(std::memory_order_acquire) - (intptr_t)pos;
+        if (diff == 0) { // the slot is free, claim it
+            if (pushPos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                break;
+        }
+        else if (diff < 0) // the slot still has the item from one round before
+            return false;
+        else // another thread claimed it first
+            pos = pushPos.load(std::memory_order_relaxed);
+    }
+    slot->item = item;
+    slot->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+template<typename T>
+bool WorkQueue<T>::pop(T& item) {
+    size_t pos = popPos.load(std::memory_order_relaxed);
+    Slot* slot;
+    while (true) {
+        slot = &slots[pos & mask];
+        intptr_t diff = (intptr_t)slot->sequence.load(std::memory_order_acquire) - (intptr_t)(pos + 1);
+        if (diff == 0) { // the slot has an item, claim it
+            if (popPos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                break;
+        }
+        else if (diff < 0) // nothing was pushed here yet
+            return false;
+        else
+            pos = popPos.load(std::memory_order_relaxed);
+    }
+    item = slot->item;
+    slot->sequence.store(pos + capacity, std::memory_order_release); // free for the push one round later
+    return true;
+}
+
+#endif
@@ -0,0 +1,143 @@
+// the shared library with the C interface of include/sawLibrary.h, built on its own (without main.cpp):
+//     g++ -std=c++17 -O2 -shared -fPIC -pthread library.cpp -o libsaw.so
+// (python/main.py looks for it next to this file)
+// the headers are all inline, so they can be included here and in other translation units of a program (embedCheck.cpp checks that)
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <algorithm>
+#include <limits>
+
+#define LARGE_BOARDS true // the cells of the C interface are 16 bit, so the search uses the same
+
+#include "include/sawLibrary.h"
+#include "include/solver.h"
+#include "include/backbiteSampler.h"
+
+// ----------------------------------------------------------------------------------------------------
+// Implementation
+// ----------------------------------------------------------------------------------------------------
+
+static bool validField(int width, int height, int start) {
+    if (width < 1 || height < 1 || (int64_t)width * height - 1 > std::numeric_limits<Cell>::max())
+        return false;
+    return start >= -1 && start < width * height;
+}
+
+int64_t sawCount(int width, int height, int start, int numThreads) {
+    if (!validField(width, height, start))
+        return -1;
+    struct Count {
+        uint64_t paths = 0;
+        void operator()(PathView) { paths++; }
+        void reduce(Count& other) { paths += other.paths; }
+    };
+    SolveOptions options;
+    options.numThreads = numThreads;
+    options.start = start;
+    Field field(width, height);
+    return solve(field, options, Count()).paths;
+}
+
+int64_t sawEnumerate(int width, int height, int start, int numThreads, uint16_t* buffer, uint64_t maxPaths) {
+    if (!validField(width, height, start) || (buffer == nullptr && maxPaths > 0))
+        return -1;
+    if (maxPaths == 0)
+        return 0;
+    // the copies of every thread claim the next free slot of the buffer, the last one stops the search
+    struct Write {
+        uint16_t* buffer;
+        uint64_t maxPaths;
+        std::atomic<uint64_t>* written;
+        bool operator()(PathView path) {
+            uint64_t slot = (*written)++;
+            if (slot >= maxPaths)
+                return false;
+            std::copy(path.begin(), path.end(), buffer + slot * path.size());
+            return slot + 1 < maxPaths;
+        }
+        void reduce(Write&) {} // the paths are already in the buffer
+    };
+    std::atomic<uint64_t> written(0);
+    SolveOptions options;
+    options.numThreads = numThreads;
+    options.start = start;
+    Field field(width, height);
+    solve(field, options, Write{buffer, maxPaths, &written});
+    return std::min((uint64_t)written, maxPaths);
+}
+
+int64_t sawEnumerateBatches(int width, int height, int start, int numThreads, uint64_t batchSize, SawBatchCallback callback, void* userData) {
+    if (!validField(width, height, start) || callback == nullptr)
+        return -1;
+    // every thread collects its paths in its own batch, a full one goes to the callback (one batch at a time), the last partly
+    // filled ones when solve reduces the threads
+    struct Batches {
+        Batches(SawBatchCallback callback, void* userData, uint64_t batchSize) : callback(callback), userData(userData), batchSize(batchSize) {}
+
+        SawBatchCallback callback;
+        void* userData;
+        uint64_t batchSize;
+        std::mutex mutex;
+        bool stopped = false;
+        uint64_t given = 0;
+
+        bool flush(const uint16_t* paths, uint64_t count) { // false once the callback stopped the search
+            std::lock_guard<std::mutex> lock(mutex);
+            if (stopped)
+                return false;
+            if (count == 0)
+                return true;
+            given += count;
+            stopped = callback(paths, count, userData) == 0;
+            return !stopped;
+        }
+    };
+    struct Batch {
+        Batch(Batches* batches) : batches(batches) {}
+
+        Batches* batches;
+        std::vector<uint16_t> paths;
+        uint64_t count = 0;
+
+        bool operator()(PathView path) {
+            paths.insert(paths.end(), path.begin(), path.end());
+            if (++count < batches->batchSize)
+                return true;
+            return flush();
+        }
+        bool flush() {
+            bool goOn = batches->flush(paths.data(), count);
+            paths.clear();
+            count = 0;
+            return goOn;
+        }
+        void reduce(Batch& other) { other.flush(); }
+    };
+    Batches batches(callback, userData, batchSize > 0 ? batchSize : 4096);
+    SolveOptions options;
+    options.numThreads = numThreads;
+    options.start = start;
+    Field field(width, height);
+    solve(field, options, Batch(&batches)).flush();
+    return batches.given;
+}
+
+int64_t sawSample(int width, int height, uint64_t seed, uint64_t burnIn, uint64_t sampleSteps, uint16_t* buffer, uint64_t numSamples) {
+    if (!validField(width, height, -1) || (buffer == nullptr && numSamples > 0))
+        return -1;
+    int cells = width * height;
+    if (burnIn == 0)
+        burnIn = 10ull * cells * std::max(width, height);
+    if (sampleSteps == 0)
+        sampleSteps = cells;
+    BackbiteSampler sampler(width, height, seed);
+    sampler.steps(burnIn);
+    for (uint64_t sample = 0; sample < numSamples; sample++) {
+        if (sample > 0)
+            sampler.steps(sampleSteps);
+        sampler.sample(buffer + sample * cells);
+    }
+    return numSamples;
+}
@@ -9,200 +9,863 @@
 #include <deque>
 #include <functional>
 #include <filesystem>
+#include <limits>
+#include <cstring>
+#include <random>
+#include <iomanip>
+#include <sstream>
+#include <atomic>
+#include <condition_variable>
 
 #define STB_IMAGE_WRITE_IMPLEMENTATION
 #include "include/stb_image_write.h"
 
 #define FASTER true // makes it slightly faster but less memory efficient
+#define COUNT_ALLOCATIONS false // counts every heap allocation (new and the Bitmap mallocs) and prints the number at the end
 
-#if FASTER
-#include "include/fastBitmap.h"
-#else
-#include "include/bitmap.h"
+#if COUNT_ALLOCATIONS
+std::atomic<size_t> allocationCount(0);
+
+void* countedMalloc(size_t size) {
+    allocationCount++;
+    return std::malloc(size);
+}
+
+void* operator new(size_t size) {
+    void* ptr = countedMalloc(size);
+    if (ptr == nullptr)
+        throw std::bad_alloc();
+    return ptr;
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t size) noexcept {
+    (void)size; // malloc knows the size itself
+    std::free(ptr);
+}
+
+#define BITMAP_MALLOC(size) countedMalloc(size)
 #endif
 
+#include "include/backbiteSampler.h"
+#include "include/pathRenderer.h"
+#include "include/threadPool.h"
+#include "include/pathFinder.h"
+#include "include/affinity.h"
+
 #define HARDCODE_SIZE false
 #define SIZE 5
 
 #define MULTITHREAD true // if it should multithread or not
+#define BATCH_CHILDREN true // checks all children of a node together on 64 bit boards (fields with up to 64 cells, AVX2 if the compiler targets it)
+#define SPECIALIZE_SIZES true // uses a search compiled for the exact size for 2x2 to 8x8 fields with the 4 straight directions
+#define LARGE_BOARDS false // uses 16 bit cell indices in paths so fields with more than 256 cells work
+
+#define STORE_SOLUTIONS true // keeps every solution path, without it only the counts are computed (which uses almost no memory)
+#define COLLECT_STATS false // counts nodes, pruned children and solutions per depth and starting position (prints a table and writes stats/statsNxN.json)
+#define REPORT_PROGRESS true // prints the finished work items, nodes/s and an ETA every PROGRESS_INTERVAL seconds while solving
+#define PROGRESS_INTERVAL 10
+#define ESTIMATE_PROBES 200 // random probes per work item to estimate its size for the ETA (and the unfinished items of a time limited run)
+#define ESTIMATE_PROBES_TOTAL 4000 // with many work items (resumed runs) the probes are split between them so they don't use up the time limit
+#define TIME_LIMIT_PROBE_SHARE 0.1 // the part of a --time-limit that is kept after the search for the probes of the unfinished work items
 
 #define OUTPUT_SOLUTIONS_PER_SQARE true // just the number of solutions where the starting position is the current sqare
+#define OUTPUT_SOLUTIONS_PER_PAIR true // the number of solutions for every starting and ending cell (row is the start, column the end)
 #define OUTPUT_SOLUTIONS_IN_FILE true
+#define OUTPUT_VISIT_HEATMAP false // a histogram of the steps at which every cell is walked on (heatmap/ as text and png), counted while solving (cells^2 counters per canonical start and thread)
+
+#if OUTPUT_SOLUTIONS_IN_FILE && !STORE_SOLUTIONS
+#error "OUTPUT_SOLUTIONS_IN_FILE needs STORE_SOLUTIONS"
+#endif
+
+#include "include/engine.h" // after the switches, the search uses them too
+#include "include/solver.h"
 
-class Pos {
+// finished paths of a fixed length stored back to back in big blocks (a slab per thread)
+// so storing a solution doesn't need a malloc or a mutex, all blocks are freed at once with the list
+class SolutionList {
 public:
-    Pos(int x = 0, int y = 0) : x(x), y(y) {}
-    ~Pos() {}
+    SolutionList(int fieldWidth, int fieldHeight, size_t solutionsPerBlock = 1 << 14);
+    SolutionList(const SolutionList& solutionList) = delete;
+    ~SolutionList();
 
-    int x, y;
+    int fieldWidth, fieldHeight;
+    int pathLength;
 
-    Pos operator+(Pos other) {
-        return Pos(x + other.x, y + other.y);
+    Cell* add(); // returns the memory for a new solution
+    void add(const Cell* path);
+    size_t size() {
+        return count;
     }
-    Pos operator-(Pos other) {
-        return Pos(x - other.x, y - other.y);
+    Cell* operator[](size_t i) {
+        return blocks[i / solutionsPerBlock] + (i % solutionsPerBlock) * pathLength;
     }
+
+private:
+    size_t solutionsPerBlock;
+    size_t count = 0;
+    std::vector<Cell*> blocks;
+};
+
+// everything one thread finds, so the threads don't share anything while solving
+// all counts are of the solutions from the canonical starting positions (before the symmetries are applied)
+class SolveResult {
+public:
+    SolveResult(int fieldWidth, int fieldHeight, bool storeSolutions = true);
+    ~SolveResult() {}
+
+    int cells;
+#if STORE_SOLUTIONS
+    bool storeSolutions; // only counts if false
+    SolutionList solutions;
+#endif
+    std::vector<uint64_t> pairCounts; // pairCounts[start * cells + end] is the number of solutions from start to end
+    uint64_t nodes = 0; // the nodes that were searched into this result
+#if OUTPUT_VISIT_HEATMAP
+    // visitCounts[(startSlots[start] * cells + cell) * cells + step] is the number of solutions from start that walk on cell at step
+    // (it's per start so the symmetries of the start can be applied at the end, only the canonical starts get a slot)
+    std::vector<int> startSlots;
+    std::vector<uint64_t> visitCounts;
+#endif
+#if COLLECT_STATS
+    SearchStats stats;
+#endif
+
+    void addSolution(const Cell* path);
 };
 
-class Candidate {
+// the permutations every start that has solutions has to be mirrored with (only the canonical starting positions have any)
+std::vector<std::vector<const Cell*>> startSymmetries(std::vector<SolveResult*>& results, SymmetryTable& symmetryTable);
+// the pair counts of all results with the symmetries applied, pairCounts[start * cells + end]
+// the symmetries are applied to the counts directly, so they don't need the paths
+std::vector<uint64_t> expandPairCounts(std::vector<SolveResult*>& results, std::vector<std::vector<const Cell*>>& symmetries, int cells);
+// the unfinished work items of a time limited run and the pair counts it found, so a later run can continue with them
+// (one line with the size, one with the pair counts and one per work item with its path)
+void saveResume(const std::string& filepath, int size, std::deque<Candidate>& unfinished, std::vector<uint64_t>& pairCounts);
+bool loadResume(const std::string& filepath, int size, std::deque<Candidate>& startingPoses, std::vector<uint64_t>& pairCounts);
+// writes the counts zero padded to the same width, one row per line
+void writeCountTable(std::ostream& os, std::vector<std::vector<uint64_t>>& counts);
+// draws count paths (getPath(i) returns the cells of the i-th) with all threads into render/ (one png each or one atlas) and prints how long it took
+template<typename GetPath>
+void renderPaths(int size, size_t count, GetPath getPath, const RenderOptions& options, bool atlas);
+
+// the probe estimates of the number of solutions of every starting position summed up
+class EstimateSums {
 public:
-    Candidate(int fieldWidth, int fieldHeight) : map(fieldWidth, fieldHeight), path(fieldWidth * fieldHeight, Pos(-1, -1)) {}
-    ~Candidate() {}
+    EstimateSums(int numStarts) : sums(numStarts, 0), squareSums(numStarts, 0), probes(numStarts, 0) {}
+    ~EstimateSums() {}
 
-    Bitmap map; // contains if a pos has been walked on
-    std::vector<Pos> path; // contains the order of of the Poses
-    int pathIndex = 0; // the current position in the path vector (instead of push_back)
+    std::vector<double> sums, squareSums;
+    std::vector<uint64_t> probes;
 
-    friend std::ostream& operator<<(std::ostream& os, Candidate& can);
+    double mean(int start) {
+        return probes[start] > 0 ? sums[start] / probes[start] : 0;
+    }
+    double variance(int start) { // of the mean
+        if (probes[start] < 2)
+            return 0;
+        double sampleVariance = (squareSums[start] - sums[start] * sums[start] / probes[start]) / (probes[start] - 1);
+        return std::max(sampleVariance, 0.0) / probes[start];
+    }
+    double halfWidth(int start) { // of the 95% confidence interval
+        return 1.96 * std::sqrt(variance(start));
+    }
 };
 
-void solve(int sizeX, int sizeY, std::deque<Candidate>* startPoses, std::deque<Candidate>* solutions, std::vector<Pos> deltaDirections);
-// if the nextPos creates a valid candidate that is not a solution it adds it to candidates or if its a solution to solutions
-void validateAndAdd(std::deque<Candidate>& candidates, std::deque<Candidate>& solutions, std::vector<Pos>& deltaDirections, Candidate candidate, Pos nextPos);
-bool checkFinished(Candidate& candidate);
-bool connected(Candidate& candidate, std::vector<Pos>& deltaDirections);
-int floodFill(Bitmap& toFill, bool valToFill, Pos currPos, std::vector<Pos>& deltaDirections);
-Candidate applyToEntirePath(Candidate candidate, std::function<Pos(Pos, int, Candidate&)> func); // creates a copy of the candidat and applies the function to the path
-// the function should take in the current pos in path the index of the pos and the Candidate and return the new pos
+// probes all starting positions in batches and merges them into sums until every confidence interval is within
+// relativeError of its estimate or timeBudget seconds since startTime are over (checked before every probe, on big
+// fields a single batch takes longer than the whole budget)
+void estimateSolutions(std::deque<Candidate>* startPoses, NeighborTable* neighborTable, EstimateSums* sums, double relativeError, double timeBudget,
+    std::chrono::high_resolution_clock::time_point startTime, uint64_t seed);
 
-std::mutex solutionsMutex; // handels data access to the shared solution vector
-std::mutex startPositionsMutex; // handels data access to the shared start positions vector
+// a field of a sweep, its starting positions are split into work items up front so any thread of the pool can take them
+class SweepBoard {
+public:
+    SweepBoard(int width, int height, std::vector<Pos>& deltaDirections, int numThreads);
+    SweepBoard(const SweepBoard& sweepBoard) = delete;
+    ~SweepBoard() {}
+
+    int width, height;
+    NeighborTable neighborTable;
+    SymmetryTable symmetryTable;
+    WorkItems workItems;
+    size_t numItems;
+    SolveResult splitResult; // solutions found while splitting the starting positions
+    std::deque<SolveResult> threadResults; // one per thread of the pool (tasks on the same thread run one after another)
+    std::atomic<int> tasksLeft;
+    double milliseconds = 0; // since the start of the sweep when the last task finished
+};
+
+// solves all the fields one after another with one thread pool, the biggest first so the small ones fill the threads
+// that run out of work items at the end of a big one, and writes one table of all of them to sweep/
+void sweep(std::vector<std::pair<int, int>>& sizes, std::vector<Pos>& deltaDirections);
+
+// pushes and pops a work item (the first row of the field) with every thread, through the WorkItems and through a
+// std::deque<Candidate> behind a mutex, and prints how many million items per second went through each
+void queueBenchmark(int size, std::vector<Pos>& deltaDirections);
+
+std::mutex estimateMutex; // handels data access to the shared EstimateSums
+std::atomic<bool> estimateFinished(false); // set (under estimateMutex) when the estimate is precise enough or the time is over
 
 int main(int argc, char** argv) {
 #if HARDCODE_SIZE
     int size = SIZE;
+    int firstOption = 1;
 #else
-    int size;
-    try {
-        if (argc < 2)
-            throw std::exception();
-        size = std::stoi(argv[1]);
+    int size = 0;
+    int firstOption = 2;
+    if (argc >= 2 && std::string(argv[1]).rfind("--", 0) == 0) // only options (a sweep doesn't need a size)
+        firstOption = 1;
+    else {
+        try {
+            if (argc < 2)
+                throw std::exception();
+            size = std::stoi(argv[1]);
+        }
+        catch (...) {
+            std::cerr << "Please enter size as an int as the first argument of this programm!" << std::endl;
+            return 1;
+        }
+    }
+#endif
+
+    // options after the size
+    // --estimate: estimates the number of solutions with random probes instead of solving (for fields that are too big)
+    // --relative-error <e>: the estimate stops when every 95% confidence interval is within e of its estimate (default 0.01)
+    // --time-budget <s>: the estimate stops after s seconds at the latest (default 60)
+    // --sample <n>: draws n random solutions with a backbite Markov chain instead of solving (works up to 64x64)
+    // --seed <s>: the seed of the sampler, the same seed and number of chains give the same samples (default 0)
+    // --chains <c>: independent chains that run in parallel, chain i uses seed + i (default 1)
+    // --burn-in <m>: moves before the first sample of every chain (default 10 * cells * size)
+    // --sample-steps <m>: moves between two samples of a chain (default the number of cells)
+    // --render <n>: draws the first n solutions (or samples) as png images into render/
+    // --render-scale <px>: pixels between two cells in the images (default 32)
+    // --render-colors <rrggbb> <rrggbb>: the color of the first and the last step of the path (default 2040c0 e04020)
+    // --atlas: draws all the images as tiles of one png instead of one png each
+    // --sweep <a>..<b> or <w>x<h>..<w>x<h>: solves every size from a x a to b x b (or every width and height in the ranges)
+    //     with one thread pool and writes one table of the counts to sweep/ (the size as the first argument isn't needed then)
+    // --find <k>: stops as soon as k solutions are found instead of solving (works up to 255x255, writes them to find/)
+    // --start <x> <y>: the cell the solutions of --find start at (default 0 0)
+    // --time-limit <s>: stops solving after s seconds (counted once the work items are set up), the counts are exact for the part
+    //     that was searched, the rest is estimated and its work items are saved to resume/ (solving never stops early without it)
+    // --resume <file>: continues with the work items of a time limited run and adds its counts (the solution files and the
+    //     heatmap only have the solutions found in this run)
+    // --queue-benchmark: pushes and pops work items with 1 to 64 threads through the lock free queue and through a deque behind
+    //     a mutex (like before) and prints the throughput of both (uses the size if there is one, otherwise 7)
+    // --warnsdorff: --find tries the neighbors with the fewest free neighbors first, so the first solution comes almost without backtracking
+    // --stream: prints every solution to stdout the moment it is found (one per line as cell indices) and only the count to stderr,
+    //     it keeps nothing, so it works for any number of solutions (needs a C++20 build, it's a coroutine)
+    // --pin: pins every solving thread to its own cpu, the nodes take turns and the cores come before their SMT siblings
+    //     (every thread allocates its result after pinning, so it lives on the thread's NUMA node)
+    // --skip-smt: one solving thread per core instead of one per hardware thread (with --pin the SMT siblings stay unused)
+    bool estimate = false;
+    double relativeError = 0.01;
+    double timeBudget = 60;
+    uint64_t numSamples = 0;
+    uint64_t seed = 0;
+    int numChains = 1;
+    uint64_t burnIn = 10ull * size * size * size;
+    uint64_t sampleSteps = size * size;
+    size_t numRender = 0;
+    RenderOptions renderOptions;
+    bool atlas = false;
+    std::vector<std::pair<int, int>> sweepSizes;
+    uint64_t numFind = 0;
+    int startX = 0, startY = 0;
+    bool warnsdorff = false;
+    double timeLimit = 0;
+    std::string resumeFile;
+    bool benchmarkQueue = false;
+    bool stream = false;
+    bool pin = false;
+    bool skipSmt = false;
+    for (int arg = firstOption; arg < argc; arg++) {
+        std::string option = argv[arg];
+        try {
+            if (option == "--estimate")
+                estimate = true;
+            else if (option == "--relative-error" && arg + 1 < argc)
+                relativeError = std::stod(argv[++arg]);
+            else if (option == "--time-budget" && arg + 1 < argc)
+                timeBudget = std::stod(argv[++arg]);
+            else if (option == "--sample" && arg + 1 < argc)
+                numSamples = std::stoull(argv[++arg]);
+            else if (option == "--seed" && arg + 1 < argc)
+                seed = std::stoull(argv[++arg]);
+            else if (option == "--chains" && arg + 1 < argc)
+                numChains = std::max(std::stoi(argv[++arg]), 1);
+            else if (option == "--burn-in" && arg + 1 < argc)
+                burnIn = std::stoull(argv[++arg]);
+            else if (option == "--sample-steps" && arg + 1 < argc)
+                sampleSteps = std::stoull(argv[++arg]);
+            else if (option == "--render" && arg + 1 < argc)
+                numRender = std::stoull(argv[++arg]);
+            else if (option == "--render-scale" && arg + 1 < argc)
+                renderOptions.scale = std::max(std::stoi(argv[++arg]), 1);
+            else if (option == "--render-colors" && arg + 2 < argc) {
+                for (uint8_t* color : {renderOptions.startColor, renderOptions.endColor}) {
+                    std::string hex = argv[++arg];
+                    if (hex.size() != 6)
+                        throw std::exception();
+                    unsigned long rgb = std::stoul(hex, nullptr, 16);
+                    for (int channel = 0; channel < 3; channel++)
+                        color[channel] = (rgb >> (16 - channel * 8)) & 0xff;
+                }
+            }
+            else if (option == "--atlas")
+                atlas = true;
+            else if (option == "--find" && arg + 1 < argc)
+                numFind = std::stoull(argv[++arg]);
+            else if (option == "--start" && arg + 2 < argc) {
+                startX = std::stoi(argv[++arg]);
+                startY = std::stoi(argv[++arg]);
+            }
+            else if (option == "--warnsdorff")
+                warnsdorff = true;
+            else if (option == "--time-limit" && arg + 1 < argc)
+                timeLimit = std::stod(argv[++arg]);
+            else if (option == "--resume" && arg + 1 < argc)
+                resumeFile = argv[++arg];
+            else if (option == "--queue-benchmark")
+                benchmarkQueue = true;
+            else if (option == "--stream")
+                stream = true;
+            else if (option == "--pin")
+                pin = true;
+            else if (option == "--skip-smt")
+                skipSmt = true;
+            else if (option == "--sweep" && arg + 1 < argc) {
+                std::string range = argv[++arg];
+                size_t separator = range.find("..");
+                if (separator == std::string::npos)
+                    throw std::exception();
+                std::string first = range.substr(0, separator), last = range.substr(separator + 2);
+                size_t firstX = first.find('x'), lastX = last.find('x');
+                if ((firstX == std::string::npos) != (lastX == std::string::npos))
+                    throw std::exception();
+                int minWidth = std::stoi(first.substr(0, firstX)), maxWidth = std::stoi(last.substr(0, lastX));
+                int minHeight = firstX == std::string::npos ? minWidth : std::stoi(first.substr(firstX + 1));
+                int maxHeight = lastX == std::string::npos ? maxWidth : std::stoi(last.substr(lastX + 1));
+                if (minWidth < 1 || minHeight < 1 || maxWidth < minWidth || maxHeight < minHeight)
+                    throw std::exception();
+                sweepSizes.clear();
+                for (int width = minWidth; width <= maxWidth; width++)
+                    for (int height = minHeight; height <= maxHeight; height++)
+                        if (firstX != std::string::npos || width == height)
+                            sweepSizes.push_back({width, height});
+            }
+            else
+                throw std::exception();
+        }
+        catch (...) {
+            std::cerr << "Unknown option or missing value: " << option << std::endl;
+            return 1;
+        }
+    }
+
+#if !MULTITHREAD
+    if (pin || skipSmt) {
+        std::cerr << "--pin and --skip-smt need MULTITHREAD set to true!" << std::endl;
+        return 1;
+    }
+#endif
+
+    // all posible movement directions (in case you also want diagonal too or just diagonal)
+    std::vector<Pos> deltaDirections = {Pos(0, -1), Pos(1, 0), Pos(0, 1), Pos(-1, 0)};
+    // std::vector<Pos> deltaDirections = {Pos(0, -1), Pos(1, 0), Pos(0, 1), Pos(-1, 0), Pos(1, -1), Pos(1, 1), Pos(-1, 1), Pos(-1, -1)}; // included diagonal Movement
+
+    if (!sweepSizes.empty()) {
+        for (int i = 0; i < sweepSizes.size(); i++) {
+            if (sweepSizes[i].first * sweepSizes[i].second - 1 > std::numeric_limits<Cell>::max()) {
+                std::cerr << "Fields with more than " << (size_t)std::numeric_limits<Cell>::max() + 1 << " cells need LARGE_BOARDS set to true!" << std::endl;
+                return 1;
+            }
+        }
+        sweep(sweepSizes, deltaDirections);
+        return 0;
     }
-    catch (...) {
+    if (benchmarkQueue) {
+        queueBenchmark(size > 0 ? size : 7, deltaDirections);
+        return 0;
+    }
+    if (size < 1) {
         std::cerr << "Please enter size as an int as the first argument of this programm!" << std::endl;
         return 1;
     }
+
+    if (numSamples > 0) {
+        if (size * size > std::numeric_limits<uint16_t>::max()) {
+            std::cerr << "The sampler only works for fields with up to " << std::numeric_limits<uint16_t>::max() << " cells!" << std::endl;
+            return 1;
+        }
+        auto sampleStart = std::chrono::high_resolution_clock::now();
+        std::vector<std::vector<uint16_t>> chainSamples(numChains); // the samples of each chain back to back
+        std::vector<std::thread> chains(numChains);
+        for (int chain = 0; chain < numChains; chain++) {
+            uint64_t chainSampleCount = numSamples / numChains + (chain < numSamples % numChains ? 1 : 0);
+            chains[chain] = std::thread([=, &chainSamples]() {
+                BackbiteSampler sampler(size, size, seed + chain);
+                sampler.steps(burnIn);
+                chainSamples[chain].resize(chainSampleCount * size * size);
+                for (uint64_t sample = 0; sample < chainSampleCount; sample++) {
+                    if (sample > 0)
+                        sampler.steps(sampleSteps);
+                    sampler.sample(chainSamples[chain].data() + sample * size * size);
+                }
+            });
+        }
+        for (int chain = 0; chain < numChains; chain++)
+            chains[chain].join();
+
+        std::chrono::duration<double, std::milli> duration = std::chrono::high_resolution_clock::now() - sampleStart;
+        std::cout << "samples: " << numSamples << std::endl;
+        std::cout << "time: " << duration.count() << "ms (" << numSamples / (duration.count() / 1000) << " samples/s)" << std::endl;
+
+        // one sample per line as the cell indices in walking order
+        std::filesystem::create_directory("samples");
+        std::ofstream samplesOutput("samples/samples" + std::to_string(size) + "x" + std::to_string(size) + ".txt");
+        for (int chain = 0; chain < numChains; chain++) {
+            for (size_t i = 0; i < chainSamples[chain].size(); i++)
+                samplesOutput << chainSamples[chain][i] << ((i + 1) % (size * size) == 0 ? '\n' : ' ');
+        }
+        samplesOutput.close();
+
+        if (numRender > 0) {
+            std::vector<const uint16_t*> samplePaths;
+            for (int chain = 0; chain < numChains; chain++)
+                for (size_t i = 0; i < chainSamples[chain].size(); i += size * size)
+                    samplePaths.push_back(chainSamples[chain].data() + i);
+            renderPaths(size, std::min(numRender, samplePaths.size()), [&](size_t i) { return samplePaths[i]; }, renderOptions, atlas);
+        }
+        return 0;
+    }
+
+    if (stream) {
+#if HAS_GENERATOR
+        if (size * size - 1 > std::numeric_limits<Cell>::max()) {
+            std::cerr << "Fields with more than " << (size_t)std::numeric_limits<Cell>::max() + 1 << " cells need LARGE_BOARDS set to true!" << std::endl;
+            return 1;
+        }
+        Field field(size, size);
+        uint64_t numSolutions = 0;
+        for (PathView path : enumerate(field)) {
+            for (int i = 0; i < path.size(); i++)
+                std::cout << (int)path[i] << (i + 1 < path.size() ? ' ' : '\n');
+            numSolutions++;
+        }
+        std::cout.flush();
+        std::cerr << "solutions: " << numSolutions << std::endl;
+        return 0;
+#else
+        std::cerr << "--stream needs a compiler with C++20 coroutines (-std=c++20)!" << std::endl;
+        return 1;
 #endif
+    }
 
-    auto start = std::chrono::high_resolution_clock::now();
+    if (numFind > 0) {
+        if (size * size > std::numeric_limits<uint16_t>::max()) {
+            std::cerr << "Finding solutions only works for fields with up to " << std::numeric_limits<uint16_t>::max() << " cells!" << std::endl;
+            return 1;
+        }
+        if (startX < 0 || startX >= size || startY < 0 || startY >= size) {
+            std::cerr << "The start has to be on the field!" << std::endl;
+            return 1;
+        }
+        // a path alternates between the two colors of the checkerboard, on an odd field it has one more cell of the corners' color
+        // so it has to start (and end) on that color, from the other one the search would walk the whole tree for nothing
+        if (size % 2 == 1 && (startX + startY) % 2 == 1) {
+            std::cerr << "There are no solutions from (" << startX << ", " << startY << "), on an odd field they start where x + y is even!" << std::endl;
+            return 1;
+        }
+        auto findStart = std::chrono::high_resolution_clock::now();
+        PathFinder finder(size, size, warnsdorff);
+        ThreadPool pool(MULTITHREAD ? std::thread::hardware_concurrency() : 1);
+        std::vector<std::vector<uint16_t>> items = finder.split(startY * size + startX, pool.numThreads);
 
-    std::deque<Candidate> startingPoses;
-    for (int x = 0; x < std::ceil(size / 2.0); x++) {
-        for (int y = 0; y <= x; y++) {
-            if ((x + y) % 2 == 1 && size % 2 == 1)
-                continue;
-            Candidate can(size, size);
-            can.path[can.pathIndex] = Pos(x, y);
-            can.pathIndex++;
-            can.map[y][x] = true;
-            startingPoses.push_back(can);
+        // the first thread that finds the k-th solution sets cancelled, every other search stops at its next node
+        std::atomic<bool> cancelled(false);
+        std::atomic<size_t> nextItem(0);
+        std::atomic<uint64_t> nodes(0);
+        std::mutex foundMutex;
+        std::vector<uint16_t> found; // the solutions back to back
+        double firstMilliseconds = 0;
+        for (int task = 0; task < pool.numThreads; task++) {
+            pool.submit([&](int) {
+                for (size_t item = nextItem++; item < items.size() && !cancelled; item = nextItem++) {
+                    nodes += finder.search(items[item], cancelled, [&](const uint16_t* path) {
+                        std::lock_guard<std::mutex> lock(foundMutex);
+                        if (found.size() / finder.cells >= numFind)
+                            return false;
+                        if (found.empty()) {
+                            std::chrono::duration<double, std::milli> duration = std::chrono::high_resolution_clock::now() - findStart;
+                            firstMilliseconds = duration.count();
+                        }
+                        found.insert(found.end(), path, path + finder.cells);
+                        if (found.size() / finder.cells >= numFind)
+                            cancelled = true;
+                        return !cancelled;
+                    });
+                }
+            });
         }
+        pool.wait();
+
+        size_t numFound = found.size() / finder.cells;
+        std::chrono::duration<double, std::milli> duration = std::chrono::high_resolution_clock::now() - findStart;
+        std::cout << "found: " << numFound << (numFound < numFind ? " (there are no more)" : "") << std::endl;
+        if (numFound > 0)
+            std::cout << "first after: " << firstMilliseconds << "ms" << std::endl;
+        std::cout << "nodes: " << nodes << std::endl;
+        std::cout << "time: " << duration.count() << "ms" << std::endl;
+
+        // one solution per line as the cell indices in walking order (like the samples)
+        std::filesystem::create_directory("find");
+        std::ofstream findOutput("find/find" + std::to_string(size) + "x" + std::to_string(size) + ".txt");
+        for (size_t i = 0; i < found.size(); i++)
+            findOutput << found[i] << ((i + 1) % finder.cells == 0 ? '\n' : ' ');
+        findOutput.close();
+
+        if (numRender > 0)
+            renderPaths(size, std::min(numRender, numFound), [&](size_t i) { return found.data() + i * finder.cells; }, renderOptions, atlas);
+        return 0;
     }
 
-    std::deque<Candidate> solutions;
+#if !STORE_SOLUTIONS
+    if (numRender > 0 && !estimate) {
+        std::cerr << "Rendering solutions needs STORE_SOLUTIONS set to true!" << std::endl;
+        return 1;
+    }
+#endif
 
-    // all posible movement directions (in case you also want diagonal too or just diagonal)
-    std::vector<Pos> deltaDirections = {Pos(0, -1), Pos(1, 0), Pos(0, 1), Pos(-1, 0)};
-    // std::vector<Pos> deltaDirections = {Pos(0, -1), Pos(1, 0), Pos(0, 1), Pos(-1, 0), Pos(1, -1), Pos(1, 1), Pos(-1, 1), Pos(-1, -1)}; // included diagonal Movement
+    if (size * size - 1 > std::numeric_limits<Cell>::max()) {
+        std::cerr << "Fields with more than " << (size_t)std::numeric_limits<Cell>::max() + 1 << " cells need LARGE_BOARDS set to true!" << std::endl;
+        return 1;
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+
+    std::deque<Candidate> startingPoses = canonicalStartingPoses(size, size);
+    std::vector<uint64_t> resumedPairCounts(size * size * size * size, 0); // what the earlier runs found
+    if (!resumeFile.empty() && !loadResume(resumeFile, size, startingPoses, resumedPairCounts)) {
+        std::cerr << "Could not read " << resumeFile << " as the work items of a " << size << "x" << size << " field!" << std::endl;
+        return 1;
+    }
+
+    Bitmap toCheck(size, size);
+    NeighborTable neighborTable(size, size, deltaDirections);
+    SymmetryTable symmetryTable(size, size);
+
+    if (estimate) {
+        size_t numEstimateThreads = MULTITHREAD ? std::max((size_t)std::thread::hardware_concurrency(), (size_t)1) : 1;
+        EstimateSums sums(startingPoses.size());
+        std::vector<std::thread> estimateThreads(numEstimateThreads);
+        for (int thread = 0; thread < estimateThreads.size(); thread++)
+            estimateThreads[thread] = std::thread(estimateSolutions, &startingPoses, &neighborTable, &sums, relativeError, timeBudget, start, thread);
+        for (int thread = 0; thread < estimateThreads.size(); thread++)
+            estimateThreads[thread].join();
+
+        // every cell a symmetry maps a starting position to has the same number of solutions
+        // the copies are perfectly correlated, so their variances add up with the square of the number of copies
+        std::vector<std::vector<uint64_t>> estimatesPerSqare(size, std::vector<uint64_t>(size, 0));
+        std::vector<std::vector<uint64_t>> halfWidthsPerSqare(size, std::vector<uint64_t>(size, 0));
+        double total = 0, totalVariance = 0;
+        uint64_t totalProbes = 0;
+        std::vector<Pos> unreached; // the starting positions none of whose probes reached a solution, 0 would be a guess there
+        for (int i = 0; i < startingPoses.size(); i++) {
+            int startCell = startingPoses[i].path[0];
+            std::vector<int> symmetries = symmetryTable.transformsOf(startCell);
+            for (int sym = 0; sym < symmetries.size(); sym++) {
+                Pos symPos = neighborTable.poses[symmetryTable.permutation(symmetries[sym])[startCell]];
+                estimatesPerSqare[symPos.y][symPos.x] = std::llround(sums.mean(i));
+                halfWidthsPerSqare[symPos.y][symPos.x] = std::llround(sums.halfWidth(i));
+            }
+            total += symmetries.size() * sums.mean(i);
+            totalVariance += symmetries.size() * symmetries.size() * sums.variance(i);
+            totalProbes += sums.probes[i];
+            if (sums.sums[i] == 0)
+                unreached.push_back(neighborTable.poses[startCell]);
+        }
+
+        std::chrono::duration<double, std::milli> duration = std::chrono::high_resolution_clock::now() - start;
+        if (unreached.size() == startingPoses.size())
+            std::cout << "estimated solutions: unknown, none of the " << totalProbes << " probes reached a solution (the field is too big for the time budget)" << std::endl;
+        else {
+            std::cout << "estimated solutions: " << total << " +- " << 1.96 * std::sqrt(totalVariance) << " (95% confidence, " << totalProbes << " probes)" << std::endl;
+            if (!unreached.empty())
+                std::cout << "no probe reached a solution from " << unreached.size() << " of the " << startingPoses.size()
+                          << " starting positions, they are left out so the estimate is too low" << std::endl;
+        }
+        std::cout << "time: " << duration.count() << "ms" << std::endl;
+
+        std::filesystem::create_directory("estimate");
+        std::ofstream estimateOutput("estimate/estimate" + std::to_string(size) + "x" + std::to_string(size) + ".txt");
+        writeCountTable(estimateOutput, estimatesPerSqare);
+        estimateOutput << "\n+- (95% confidence)\n";
+        writeCountTable(estimateOutput, halfWidthsPerSqare);
+        if (!unreached.empty()) {
+            estimateOutput << "\nno probe reached a solution from (these are unknown, not 0):";
+            for (int i = 0; i < unreached.size(); i++)
+                estimateOutput << " (" << unreached[i].x << ", " << unreached[i].y << ")";
+            estimateOutput << "\n";
+        }
+        estimateOutput.close();
+        return 0;
+    }
+
+    SolveResult result(size, size); // solutions found while splitting the starting positions
 
 #if MULTITHREAD
 
     size_t numThreads = (size_t)std::thread::hardware_concurrency();
-    for (int i = startingPoses.size(); i < numThreads;) {
-        Candidate currCan = startingPoses.back();
-        startingPoses.pop_back();
-        for (int dir = 0; dir < deltaDirections.size(); dir++) {
-            Pos newPos = currCan.path[currCan.pathIndex - 1] + deltaDirections[dir];
-            validateAndAdd(startingPoses, solutions, deltaDirections, currCan, newPos);
-        }
-        i = startingPoses.size();
+    if (skipSmt)
+        numThreads = std::min(numThreads, (size_t)numCores());
+    splitStartingPoses(startingPoses, result, neighborTable, toCheck, numThreads);
+#endif
+
+    SolveFunction<SolveResult> solveFunction = solveItems<SolveResult>;
+#if SPECIALIZE_SIZES
+    if (fixedSolve<SolveResult>(size, size, deltaDirections) != nullptr)
+        solveFunction = fixedSolve<SolveResult>(size, size, deltaDirections);
+#endif
+
+    Progress* progressPtr = nullptr;
+#if REPORT_PROGRESS
+    std::vector<double> estimates(startingPoses.size(), 0);
+    std::mt19937_64 rng(0);
+    int itemProbes = probesPerItem(startingPoses.size());
+    for (int i = 0; i < startingPoses.size(); i++) {
+        for (int probe = 0; probe < itemProbes; probe++)
+            estimates[i] += probeTree(startingPoses[i], neighborTable, toCheck, rng).nodes;
+        estimates[i] /= itemProbes;
+    }
+    Progress progress(estimates);
+    progressPtr = &progress;
+    std::cout << "estimated nodes: " << (uint64_t)progress.totalEstimate << std::endl;
+    std::thread reporter(&Progress::run, &progress, std::ref(std::cout), (double)PROGRESS_INTERVAL);
+#endif
+
+    // the limit is counted from here, after the probes for the ETA (with a short limit they would use it all up and a resumed run
+    // would never get to search), the search gets its part and the rest is for the probes of the work items it doesn't finish
+    auto solveStart = std::chrono::high_resolution_clock::now();
+    auto searchEnd = solveStart + std::chrono::duration_cast<std::chrono::high_resolution_clock::duration>(
+        std::chrono::duration<double>(timeLimit * (1 - TIME_LIMIT_PROBE_SHARE)));
+    auto limitEnd = solveStart + std::chrono::duration_cast<std::chrono::high_resolution_clock::duration>(std::chrono::duration<double>(timeLimit));
+
+    // taken from the back like before, the item number is the index of the starting position
+    WorkItems workItems(neighborTable, startingPoses.size() * 2);
+    for (int i = startingPoses.size() - 1; i >= 0; i--)
+        workItems.add(startingPoses[i].path.data(), startingPoses[i].pathIndex, i);
+
+    // the timer stops the work items once the search's part of the limit is over, unless the solving is done before
+    std::mutex timerMutex;
+    std::condition_variable timerStopped;
+    bool solvingDone = false;
+    std::thread timer;
+    if (timeLimit > 0) {
+        timer = std::thread([&]() {
+            std::unique_lock<std::mutex> lock(timerMutex);
+            if (!timerStopped.wait_until(lock, searchEnd, [&]() { return solvingDone; }))
+                workItems.stop();
+        });
     }
 
+#if MULTITHREAD
     if (numThreads == 0) numThreads = 1;
     std::vector<std::thread> threads(numThreads);
+    std::vector<CpuInfo> threadCpus = workerCpus(numThreads, skipSmt);
+    // each thread writes into its own result, allocated (and filled with zeros) by the thread itself after it is pinned
+    std::vector<std::unique_ptr<SolveResult>> threadResults(numThreads);
+    std::vector<double> threadSeconds(numThreads, 0);
+    std::vector<int> threadCpu(numThreads, -1); // the cpu the thread ended on
 
-    for (int thread = 0; thread < threads.size(); thread++)
-        threads[thread] = std::thread(solve, size, size, &startingPoses, &solutions, deltaDirections);
+    for (int thread = 0; thread < threads.size(); thread++) {
+        threads[thread] = std::thread([&, thread]() {
+            if (pin && !pinCurrentThread(threadCpus[thread].cpu))
+                std::cout << "couldn't pin thread " << thread << " to cpu " << threadCpus[thread].cpu << std::endl;
+            threadResults[thread] = std::make_unique<SolveResult>(size, size);
+            auto threadStart = std::chrono::high_resolution_clock::now();
+            solveFunction(size, size, &workItems, threadResults[thread].get(), &neighborTable, progressPtr);
+            threadSeconds[thread] = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - threadStart).count();
+            threadCpu[thread] = currentCpu();
+        });
+    }
 
-    std::cout << "started " << threads.size() << " threads!" << std::endl;
+    std::cout << "started " << threads.size() << " threads" << (pin ? " (pinned)" : "") << "!" << std::endl;
 
+    std::vector<double> nodeThroughput; // nodes per second of the threads of every NUMA node
     for (int thread = 0; thread < threads.size(); thread++) {
         threads[thread].join();
-        std::cout << "thread " << thread << " finished!" << std::endl;
+        uint64_t nodes = threadResults[thread]->nodes;
+        double throughput = threadSeconds[thread] > 0 ? nodes / threadSeconds[thread] : 0;
+        int node = threadCpu[thread] >= 0 ? nodeOfCpu(threadCpu[thread]) : 0;
+        if (node >= nodeThroughput.size())
+            nodeThroughput.resize(node + 1, 0);
+        nodeThroughput[node] += throughput;
+        std::cout << "thread " << thread << " finished! (cpu " << threadCpu[thread] << ", NUMA node " << node << ", " << nodes << " nodes, "
+                  << (uint64_t)throughput << " nodes/s)" << std::endl;
     }
+    for (int node = 0; node < nodeThroughput.size(); node++)
+        if (nodeThroughput[node] > 0)
+            std::cout << "NUMA node " << node << ": " << (uint64_t)nodeThroughput[node] << " nodes/s" << std::endl;
 
 #else
-    solve(size, size, &startingPoses, &solutions, deltaDirections);
-#endif
-
-    std::deque<Candidate> allSolutions;
-
-    // if x == y you only have to mirror it over x, y and xy
-    // if x != y you have to create a new solution by swapping x and y and mirroring it over x, y and xy 
-    // if x == size / 2.0 you don't mirror vertically
-    // if y == size / 2.0 you don't mirror horizontally
-    while (!solutions.empty()) {
-        std::vector<Candidate> currSolution = {solutions.back()};
-        solutions.pop_back();
-
-        if (currSolution[0].path[0].x != currSolution[0].path[0].y)
-            currSolution.push_back(applyToEntirePath(currSolution[0], [](Pos curr, int i, Candidate c) -> Pos {
-                return Pos(curr.y, curr.x);
-            }));
-        
-        for (int i = 0; i < currSolution.size(); i++) {
-            int cases = 0;
-            if (currSolution[i].path[0].x != (currSolution[i].map.width - 1) / 2.0) {
-                cases++;
-                allSolutions.push_back(applyToEntirePath(currSolution[i], [](Pos curr, int i, Candidate& c) -> Pos {
-                    return Pos(c.map.width - curr.x - 1, curr.y);
-                }));
+    solveFunction(size, size, &workItems, &result, &neighborTable, progressPtr);
+#endif
+
+#if REPORT_PROGRESS
+    progress.stop();
+    reporter.join();
+#endif
+    if (timer.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(timerMutex);
+            solvingDone = true;
+        }
+        timerStopped.notify_all();
+        timer.join();
+    }
+
+    // the work items that weren't started and the rest of the ones that were stopped
+    std::deque<Candidate> unfinished = workItems.remaining(size, size);
+
+    std::vector<SolveResult*> results = {&result};
+#if MULTITHREAD
+    for (int thread = 0; thread < threadResults.size(); thread++)
+        results.push_back(threadResults[thread].get());
+#endif
+
+    int cells = size * size;
+    std::vector<std::vector<const Cell*>> symmetries = startSymmetries(results, symmetryTable);
+    std::vector<uint64_t> pairCounts = expandPairCounts(results, symmetries, cells);
+    uint64_t numSolutions = 0;
+    for (int i = 0; i < pairCounts.size(); i++) {
+        pairCounts[i] += resumedPairCounts[i];
+        numSolutions += pairCounts[i];
+    }
+
+    // every unfinished work item is estimated with random probes (once for every cell a symmetry moves its start to) in the rest of
+    // the time limit, the items take turns so the probes are spread evenly and the ones that got none count as the mean of the others
+    std::vector<double> probeSums(unfinished.size(), 0);
+    std::vector<int> probeCounts(unfinished.size(), 0);
+    std::mt19937_64 unfinishedRng(0);
+    int unfinishedProbes = probesPerItem(unfinished.size());
+    bool probeTimeLeft = true;
+    for (int probe = 0; probe < unfinishedProbes && probeTimeLeft; probe++) {
+        for (int i = 0; i < unfinished.size(); i++) {
+            if (std::chrono::high_resolution_clock::now() >= limitEnd) {
+                probeTimeLeft = false;
+                break;
             }
-            if (currSolution[i].path[0].y != (currSolution[i].map.height - 1) / 2.0) {
-                cases++;
-                allSolutions.push_back(applyToEntirePath(currSolution[i], [](Pos curr, int i, Candidate& c) -> Pos {
-                    return Pos(curr.x, c.map.height - curr.y - 1);
-                }));
+            probeSums[i] += probeTree(unfinished[i], neighborTable, toCheck, unfinishedRng).solutions;
+            probeCounts[i]++;
+        }
+    }
+    double probedMean = 0;
+    int numProbed = 0;
+    for (int i = 0; i < unfinished.size(); i++) {
+        if (probeCounts[i] > 0) {
+            probedMean += probeSums[i] / probeCounts[i];
+            numProbed++;
+        }
+    }
+    probedMean = numProbed > 0 ? probedMean / numProbed : 0;
+    double unfinishedEstimate = 0;
+    for (int i = 0; i < unfinished.size(); i++) {
+        double itemEstimate = probeCounts[i] > 0 ? probeSums[i] / probeCounts[i] : probedMean;
+        unfinishedEstimate += itemEstimate * symmetryTable.transformsOf(unfinished[i].path[0]).size();
+    }
+
+#if OUTPUT_VISIT_HEATMAP
+    std::vector<uint64_t> visitCounts(cells * cells, 0); // visitCounts[cell * cells + step] over all solutions
+    for (int res = 0; res < results.size(); res++) {
+        for (int start = 0; start < cells; start++) {
+            if (results[res]->startSlots[start] < 0)
+                continue;
+            for (int cell = 0; cell < cells; cell++) {
+                const uint64_t* counts = results[res]->visitCounts.data() + ((size_t)results[res]->startSlots[start] * cells + cell) * cells;
+                for (int sym = 0; sym < symmetries[start].size(); sym++) {
+                    int symCell = symmetries[start][sym][cell];
+                    for (int step = 0; step < cells; step++)
+                        visitCounts[symCell * cells + step] += counts[step];
+                }
             }
-            if (cases == 2)
-                allSolutions.push_back(applyToEntirePath(currSolution[i], [](Pos curr, int i, Candidate& c) -> Pos {
-                    return Pos(c.map.width - curr.x - 1, c.map.height - curr.y - 1);
-                }));
-            allSolutions.push_back(currSolution[i]);
         }
     }
+#endif
+
+#if COLLECT_STATS
+    SearchStats stats(size, size);
+    for (int res = 0; res < results.size(); res++)
+        stats.merge(results[res]->stats);
+#endif
+
+#if STORE_SOLUTIONS
+    SolutionList allSolutions(size, size);
+    for (int res = 0; res < results.size(); res++) {
+        SolutionList& solutions = results[res]->solutions;
+        for (size_t solution = 0; solution < solutions.size(); solution++) {
+            std::vector<const Cell*>& solutionSymmetries = symmetries[solutions[solution][0]];
+            for (int sym = 0; sym < solutionSymmetries.size(); sym++)
+                applyToEntirePath(solutions[solution], allSolutions.add(), solutionSymmetries[sym], cells);
+        }
+    }
+#endif
+#if MULTITHREAD
+    threadResults.clear();
+#endif
 
     auto end = std::chrono::high_resolution_clock::now();
     std::chrono::duration<double, std::milli> duration = end - start;
 
-    // allSolutions now contains all possible solutions
-    std::cout << "solutions: " << allSolutions.size() << std::endl;
+    std::cout << "solutions: " << numSolutions << (unfinished.empty() ? "" : " (in the finished part)") << std::endl;
     std::cout << "time: " << duration.count() << "ms" << std::endl;
+    if (!unfinished.empty()) {
+        std::string resumePath = "resume/resume" + std::to_string(size) + "x" + std::to_string(size) + ".txt";
+        std::filesystem::create_directory("resume");
+        saveResume(resumePath, size, unfinished, pairCounts);
+        std::cout << "time limit reached, unfinished work items: " << unfinished.size() << std::endl;
+        if (numProbed > 0)
+            std::cout << "estimated solutions in them: " << (uint64_t)unfinishedEstimate << " (total about " << (uint64_t)(numSolutions + unfinishedEstimate) << ")" << std::endl;
+        else
+            std::cout << "estimated solutions in them: unknown, no time was left to probe them" << std::endl;
+        std::cout << "continue with: --resume " << resumePath << std::endl;
+    }
+
+#if COLLECT_STATS // the stats are of the canonical starting positions (before the symmetries are applied)
+    stats.printSummary(std::cout);
+    std::filesystem::create_directory("stats");
+    std::ofstream statsOutput("stats/stats" + std::to_string(size) + "x" + std::to_string(size) + ".json");
+    stats.writeJson(statsOutput);
+    statsOutput.close();
+#endif
 
     auto outputStart = std::chrono::high_resolution_clock::now();
 
 #if OUTPUT_SOLUTIONS_PER_SQARE
     std::filesystem::create_directory("solPerSqr");
     std::ofstream solPerSqrOutput("solPerSqr/solPerSqr" + std::to_string(size) + "x" + std::to_string(size) + ".txt");
-    std::vector<std::vector<int>> solutionsPerSqare(size, std::vector<int>(size, 0));
-    for (int i = 0; i < allSolutions.size(); i++)
-        solutionsPerSqare[allSolutions[i].path[0].y][allSolutions[i].path[0].x]++;
-
-    int maxDigits = 0;
-    for (int y = 0; y < solutionsPerSqare.size(); y++)
-        for (int x = 0; x < solutionsPerSqare[y].size(); x++)
-            maxDigits = std::max(std::to_string(solutionsPerSqare[y][x]).size(), (size_t)maxDigits);
-    
-    for (int y = 0; y < solutionsPerSqare.size(); y++) {
-        for (int x = 0; x < solutionsPerSqare[y].size(); x++) {
-            solPerSqrOutput << std::string(maxDigits - std::to_string(solutionsPerSqare[y][x]).size(), '0');
-            solPerSqrOutput << solutionsPerSqare[y][x] << ' ';
-        }
-        solPerSqrOutput << '\n';
-    }
+    std::vector<std::vector<uint64_t>> solutionsPerSqare(size, std::vector<uint64_t>(size, 0));
+    for (int start = 0; start < cells; start++)
+        for (int end = 0; end < cells; end++)
+            solutionsPerSqare[neighborTable.poses[start].y][neighborTable.poses[start].x] += pairCounts[start * cells + end];
+    writeCountTable(solPerSqrOutput, solutionsPerSqare);
     solPerSqrOutput.close();
 #endif
 
+#if OUTPUT_SOLUTIONS_PER_PAIR
+    std::filesystem::create_directory("solPerPair");
+    std::ofstream solPerPairOutput("solPerPair/solPerPair" + std::to_string(size) + "x" + std::to_string(size) + ".txt");
+    std::vector<std::vector<uint64_t>> solutionsPerPair(cells, std::vector<uint64_t>(cells, 0));
+    for (int start = 0; start < cells; start++)
+        for (int end = 0; end < cells; end++)
+            solutionsPerPair[start][end] = pairCounts[start * cells + end];
+    writeCountTable(solPerPairOutput, solutionsPerPair);
+    solPerPairOutput.close();
+#endif
+
 #if OUTPUT_SOLUTIONS_IN_FILE
     std::vector<std::string> numberTranslation(size * size, "0");
     int numDigits = std::to_string(size * size - 1).size();
@@ -212,12 +875,14 @@ int main(int argc, char** argv) {
 
     std::filesystem::create_directory("out");
     std::ofstream file("out/output" + std::to_string(size) + "x" + std::to_string(size) + ".txt");
-    for (int i = 0; i < allSolutions.size(); i++) {
-        std::vector<std::vector<std::string>> values(allSolutions[i].map.height, std::vector<std::string>(allSolutions[i].map.width, none));
-        for (int p = 0; p < allSolutions[i].path.size() && p < allSolutions[i].pathIndex; p++)
-            values[allSolutions[i].path[p].y][allSolutions[i].path[p].x] = numberTranslation[p];
-        for (int y = 0; y < allSolutions[i].map.height; y++) {
-            for (int x = 0; x < allSolutions[i].map.width; x++)
+    for (size_t i = 0; i < allSolutions.size(); i++) {
+        std::vector<std::vector<std::string>> values(allSolutions.fieldHeight, std::vector<std::string>(allSolutions.fieldWidth, none));
+        for (int p = 0; p < allSolutions.pathLength; p++) {
+            Pos pos = neighborTable.poses[allSolutions[i][p]];
+            values[pos.y][pos.x] = numberTranslation[p];
+        }
+        for (int y = 0; y < allSolutions.fieldHeight; y++) {
+            for (int x = 0; x < allSolutions.fieldWidth; x++)
                 file << values[y][x] << " ";
             file << "\n";
         }
@@ -226,116 +891,379 @@ int main(int argc, char** argv) {
     file.close();
 #endif
 
+#if OUTPUT_VISIT_HEATMAP
+    // the histogram with one row per cell and one column per step, as a table and a png
+    // (the png is scaled per row, so every cell shows where its own peak is)
+    // every path is also counted backwards, so every row is symmetric and the mean step of every cell is (cells - 1) / 2
+    std::filesystem::create_directory("heatmap");
+    std::ofstream heatmapOutput("heatmap/histogram" + std::to_string(size) + "x" + std::to_string(size) + ".txt");
+    std::vector<double> histogram(cells * cells, 0);
+    for (int cell = 0; cell < cells; cell++) {
+        uint64_t maxCount = 0;
+        for (int step = 0; step < cells; step++)
+            maxCount = std::max(maxCount, visitCounts[cell * cells + step]);
+        for (int step = 0; step < cells; step++)
+            histogram[cell * cells + step] = maxCount > 0 ? (double)visitCounts[cell * cells + step] / maxCount : 0;
+    }
+    for (int cell = 0; cell < cells; cell++) {
+        for (int step = 0; step < cells; step++)
+            heatmapOutput << visitCounts[cell * cells + step] << ' ';
+        heatmapOutput << '\n';
+    }
+    heatmapOutput.close();
+    writeHeatmap("heatmap/histogram" + std::to_string(size) + "x" + std::to_string(size) + ".png", cells, cells, histogram.data(), 0, 1, renderOptions);
+#endif
+
+#if STORE_SOLUTIONS
+    if (numRender > 0)
+        renderPaths(size, std::min(numRender, allSolutions.size()), [&](size_t i) { return allSolutions[i]; }, renderOptions, atlas);
+#endif
+
     auto outputEnd = std::chrono::high_resolution_clock::now();
     std::chrono::duration<double, std::milli> outputDuration = outputEnd - outputStart;
 
     std::cout << "time to write to file: " << outputDuration.count() << "ms" << std::endl;
+#if COUNT_ALLOCATIONS
+    std::cout << "allocations: " << allocationCount << std::endl;
+#endif
 }
 
-std::ostream& operator<<(std::ostream& os, Candidate& can) {
-    int digits = std::to_string(can.map.width * can.map.height - 1).size();
-    os << std::endl;
-    std::vector<std::vector<std::string>> values(can.map.height, std::vector<std::string>(can.map.width, std::string(digits, '-')));
-    for (int i = 0; i < can.path.size() && i < can.pathIndex; i++) {
-        std::string iString = std::to_string(i);
-        values[can.path[i].y][can.path[i].x] = std::string(digits - iString.size(), '0') + iString;
-    }
-    for (int y = 0; y < can.map.height; y++) {
-        for (int x = 0; x < can.map.width; x++)
-            os << values[y][x] << " ";
-        os << std::endl;
+SolutionList::SolutionList(int fieldWidth, int fieldHeight, size_t solutionsPerBlock) : fieldWidth(fieldWidth), fieldHeight(fieldHeight),
+        pathLength(fieldWidth * fieldHeight), solutionsPerBlock(solutionsPerBlock) {}
+
+SolutionList::~SolutionList() {
+    for (int i = 0; i < blocks.size(); i++)
+        std::free(blocks[i]);
+}
+
+Cell* SolutionList::add() {
+    if (count % solutionsPerBlock == 0) {
+        Cell* block = (Cell*)std::malloc(solutionsPerBlock * pathLength * sizeof(Cell));
+        if (block == nullptr)
+            throw std::bad_alloc();
+        blocks.push_back(block);
     }
-    return os;
+    count++;
+    return (*this)[count - 1];
+}
+
+void SolutionList::add(const Cell* path) {
+    Cell* solution = add();
+    std::copy(path, path + pathLength, solution);
+}
+
+SolveResult::SolveResult(int fieldWidth, int fieldHeight, bool storeSolutions) : cells(fieldWidth * fieldHeight),
+#if STORE_SOLUTIONS
+        storeSolutions(storeSolutions), solutions(fieldWidth, fieldHeight),
+#endif
+        pairCounts(fieldWidth * fieldHeight * fieldWidth * fieldHeight, 0)
+#if OUTPUT_VISIT_HEATMAP
+        , startSlots(cells, -1)
+#endif
+#if COLLECT_STATS
+        , stats(fieldWidth, fieldHeight)
+#endif
+        {
+#if !STORE_SOLUTIONS
+    (void)storeSolutions; // nothing is stored anyway
+#endif
+#if OUTPUT_VISIT_HEATMAP
+    std::vector<int> startCells = canonicalStartCells(fieldWidth, fieldHeight);
+    for (int i = 0; i < startCells.size(); i++)
+        startSlots[startCells[i]] = i;
+    visitCounts.resize(startCells.size() * cells * cells, 0);
+#endif
+}
+
+void SolveResult::addSolution(const Cell* path) {
+    pairCounts[path[0] * cells + path[cells - 1]]++;
+#if OUTPUT_VISIT_HEATMAP
+    uint64_t* startVisits = visitCounts.data() + (size_t)startSlots[path[0]] * cells * cells;
+    for (int step = 0; step < cells; step++)
+        startVisits[path[step] * cells + step]++;
+#endif
+#if STORE_SOLUTIONS
+    if (storeSolutions)
+        solutions.add(path);
+#endif
 }
 
-void solve(int sizeX, int sizeY, std::deque<Candidate>* startPoses, std::deque<Candidate>* solutions, std::vector<Pos> deltaDirections) {
+void estimateSolutions(std::deque<Candidate>* startPoses, NeighborTable* neighborTable, EstimateSums* sums, double relativeError, double timeBudget,
+        std::chrono::high_resolution_clock::time_point startTime, uint64_t seed) {
+    const int probesPerBatch = 64;
+    const uint64_t minProbes = 1000; // so a few lucky probes can't end the estimate early
+    std::mt19937_64 rng(seed);
+    Bitmap toCheck(neighborTable->width, neighborTable->height);
+    EstimateSums batch(startPoses->size());
+
+    bool outOfTime = false;
     while (true) {
-        startPositionsMutex.lock();
-        if (startPoses->empty()) {
-            startPositionsMutex.unlock();
-            break;
+        for (int start = 0; start < startPoses->size() && !outOfTime; start++) {
+            for (int probe = 0; probe < probesPerBatch; probe++) {
+                std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - startTime;
+                if (elapsed.count() >= timeBudget || estimateFinished) {
+                    outOfTime = true;
+                    break;
+                }
+                double solutions = probeTree((*startPoses)[start], *neighborTable, toCheck, rng).solutions;
+                batch.sums[start] += solutions;
+                batch.squareSums[start] += solutions * solutions;
+                batch.probes[start]++;
+            }
+        }
+
+        // a batch cut short by the time is merged too, on the biggest fields those are the only probes there are
+        std::lock_guard<std::mutex> lock(estimateMutex);
+        bool precise = true;
+        for (int start = 0; start < startPoses->size(); start++) {
+            sums->sums[start] += batch.sums[start];
+            sums->squareSums[start] += batch.squareSums[start];
+            sums->probes[start] += batch.probes[start];
+            batch.sums[start] = batch.squareSums[start] = 0;
+            batch.probes[start] = 0;
+            if (sums->probes[start] < minProbes || sums->mean(start) == 0 || sums->halfWidth(start) > relativeError * sums->mean(start))
+                precise = false;
         }
-        Candidate initialCandidate = startPoses->back();
-        startPoses->pop_back();
-        startPositionsMutex.unlock();
+        if (precise || outOfTime || estimateFinished) {
+            estimateFinished = true;
+            return;
+        }
+    }
+}
 
-        std::deque<Candidate> candidates = {initialCandidate};
+SweepBoard::SweepBoard(int width, int height, std::vector<Pos>& deltaDirections, int numThreads) : width(width), height(height),
+        neighborTable(width, height, deltaDirections), symmetryTable(width, height), workItems(neighborTable, numThreads * 4, false),
+        splitResult(width, height, false), tasksLeft(numThreads) {
+    Bitmap toCheck(width, height);
+    std::deque<Candidate> startingPoses = canonicalStartingPoses(width, height);
+    splitStartingPoses(startingPoses, splitResult, neighborTable, toCheck, numThreads);
+    numItems = startingPoses.size();
+    for (int i = startingPoses.size() - 1; i >= 0; i--)
+        workItems.add(startingPoses[i].path.data(), startingPoses[i].pathIndex, i);
+    for (int thread = 0; thread < numThreads; thread++)
+        threadResults.emplace_back(width, height, false);
+}
 
-        while (!candidates.empty()) {
-            Candidate currCandidate = candidates.back();
-            candidates.pop_back();
+void sweep(std::vector<std::pair<int, int>>& sizes, std::vector<Pos>& deltaDirections) {
+    auto start = std::chrono::high_resolution_clock::now();
+    ThreadPool pool(MULTITHREAD ? std::thread::hardware_concurrency() : 1);
 
-            // try to create candidates in each direction
-            for (int dir = 0; dir < deltaDirections.size(); dir++) {
-                Pos newPos = currCandidate.path[currCandidate.pathIndex - 1] + deltaDirections[dir];
-                validateAndAdd(candidates, *solutions, deltaDirections, currCandidate, newPos);
-            }
+    std::vector<std::pair<int, int>> order = sizes;
+    std::stable_sort(order.begin(), order.end(), [](const std::pair<int, int>& a, const std::pair<int, int>& b) {
+        return a.first * a.second > b.first * b.second;
+    });
+    std::deque<SweepBoard> boards;
+    for (int i = 0; i < order.size(); i++) {
+        SweepBoard& board = boards.emplace_back(order[i].first, order[i].second, deltaDirections, pool.numThreads);
+        SolveFunction<SolveResult> solveFunction = solveItems<SolveResult>;
+#if SPECIALIZE_SIZES
+        if (fixedSolve<SolveResult>(board.width, board.height, deltaDirections) != nullptr)
+            solveFunction = fixedSolve<SolveResult>(board.width, board.height, deltaDirections);
+#endif
+        // every thread can take a task of every board, the tasks of a board take its work items until none are left
+        for (int task = 0; task < pool.numThreads; task++) {
+            pool.submit([&board, solveFunction, start](int thread) {
+                solveFunction(board.width, board.height, &board.workItems, &board.threadResults[thread], &board.neighborTable, nullptr);
+                if (--board.tasksLeft == 0) {
+                    std::chrono::duration<double, std::milli> duration = std::chrono::high_resolution_clock::now() - start;
+                    board.milliseconds = duration.count();
+                }
+            });
         }
     }
+    pool.wait();
+
+    std::chrono::duration<double, std::milli> duration = std::chrono::high_resolution_clock::now() - start;
+    std::string name = std::to_string(sizes.front().first) + "x" + std::to_string(sizes.front().second) + "-"
+        + std::to_string(sizes.back().first) + "x" + std::to_string(sizes.back().second);
+    std::filesystem::create_directory("sweep");
+    std::ofstream sweepOutput("sweep/sweep" + name + ".txt");
+
+    // in the order they were asked for, the time is since the start of the sweep because the boards overlap
+    for (std::ostream* os : {(std::ostream*)&std::cout, (std::ostream*)&sweepOutput})
+        *os << std::left << std::setw(8) << "size" << std::setw(24) << "solutions" << std::setw(12) << "items" << "done after" << '\n';
+    for (int i = 0; i < sizes.size(); i++) {
+        SweepBoard* board = nullptr;
+        for (int j = 0; j < boards.size() && board == nullptr; j++)
+            if (boards[j].width == sizes[i].first && boards[j].height == sizes[i].second)
+                board = &boards[j];
+
+        std::vector<SolveResult*> results = {&board->splitResult};
+        for (int thread = 0; thread < board->threadResults.size(); thread++)
+            results.push_back(&board->threadResults[thread]);
+        std::vector<std::vector<const Cell*>> symmetries = startSymmetries(results, board->symmetryTable);
+        std::vector<uint64_t> pairCounts = expandPairCounts(results, symmetries, board->width * board->height);
+        uint64_t numSolutions = 0;
+        for (int pair = 0; pair < pairCounts.size(); pair++)
+            numSolutions += pairCounts[pair];
+
+        std::string size = std::to_string(board->width) + "x" + std::to_string(board->height);
+        std::string milliseconds = std::to_string((uint64_t)board->milliseconds) + "ms";
+        for (std::ostream* os : {(std::ostream*)&std::cout, (std::ostream*)&sweepOutput})
+            *os << std::setw(8) << size << std::setw(24) << numSolutions << std::setw(12) << board->numItems << milliseconds << '\n';
+    }
+    sweepOutput.close();
+    std::cout << "threads: " << pool.numThreads << std::endl;
+    std::cout << "time: " << duration.count() << "ms" << std::endl;
 }
 
-void validateAndAdd(std::deque<Candidate>& candidates, std::deque<Candidate>& solutions, std::vector<Pos>& deltaDirections, Candidate candidate, Pos nextPos) {
-    if (nextPos.x < 0 || nextPos.x >= candidate.map.width || nextPos.y < 0 || nextPos.y >= candidate.map.height)
-        return;
-    if (candidate.map[nextPos.y][nextPos.x])
-        return;
-    candidate.path[candidate.pathIndex] = nextPos;
-    candidate.pathIndex++;
-    candidate.map[nextPos.y][nextPos.x] = true;
-    if (checkFinished(candidate)) {
-#if FASTER // this is just for memory optimization, becuase the map is no longer needed after its a solution
-        if (candidate.map.data != nullptr) {
-            for (int y = 0; y < candidate.map.height; y++)
-                std::free(candidate.map.data[y]);
-            std::free(candidate.map.data);
-            candidate.map.data = nullptr;
+void queueBenchmark(int size, std::vector<Pos>& deltaDirections) {
+    const int totalItems = 1 << 20;
+    NeighborTable neighborTable(size, size, deltaDirections);
+    std::vector<Cell> firstRow(size);
+    for (int x = 0; x < size; x++)
+        firstRow[x] = x;
+    Candidate candidate = prefixCandidate(size, size, firstRow.data(), size);
+
+    // a pop of the lock free queue can miss while another thread's push isn't published yet, those pairs don't count
+    std::cout << std::left << std::setw(10) << "threads" << std::setw(20) << "lock free (M/s)" << std::setw(20) << "mutex (M/s)"
+        << "lock free misses" << std::endl;
+    for (int numThreads = 1; numThreads <= 64; numThreads *= 2) {
+        int threadItems = totalItems / numThreads;
+        double millions[2];
+        std::atomic<uint64_t> misses(0);
+        for (int lockFree = 1; lockFree >= 0; lockFree--) {
+            WorkItems workItems(neighborTable, numThreads, false);
+            std::deque<Candidate> candidates;
+            std::mutex candidatesMutex;
+            auto benchmarkStart = std::chrono::high_resolution_clock::now();
+            std::vector<std::thread> threads(numThreads);
+            for (int thread = 0; thread < numThreads; thread++) {
+                threads[thread] = std::thread([&]() {
+                    std::vector<Cell> path(size * size);
+                    Candidate popped(size, size);
+                    int item;
+                    for (int i = 0; i < threadItems; i++) {
+                        if (lockFree) {
+                            workItems.add(firstRow.data(), size, i);
+                            if (workItems.next(path.data(), item) > 0)
+                                workItems.done(); // only a thread that got an item is searching
+                            else
+                                misses++;
+                        }
+                        else {
+                            candidatesMutex.lock();
+                            candidates.push_back(candidate);
+                            candidatesMutex.unlock();
+                            candidatesMutex.lock();
+                            popped = std::move(candidates.back());
+                            candidates.pop_back();
+                            candidatesMutex.unlock();
+                        }
+                    }
+                });
+            }
+            for (int thread = 0; thread < numThreads; thread++)
+                threads[thread].join();
+            std::chrono::duration<double> duration = std::chrono::high_resolution_clock::now() - benchmarkStart;
+            millions[lockFree] = (double)(threadItems * numThreads - (lockFree ? (uint64_t)misses : 0)) / duration.count() / 1e6;
         }
-#else
-        if (candidate.map.data != nullptr)
-            std::free(candidate.map.data);
-        candidate.map.data = nullptr;
-#endif
-        std::lock_guard<std::mutex> lock(solutionsMutex);
-        solutions.push_back(candidate); // maybe make each thread return its solution list so you don't have to use the mutex
+        std::cout << std::setw(10) << numThreads << std::setw(20) << millions[1] << std::setw(20) << millions[0] << misses << std::endl;
     }
-    else if (connected(candidate, deltaDirections))
-        candidates.push_back(candidate);
 }
 
-bool checkFinished(Candidate& candidate) {
-    return candidate.pathIndex >= candidate.map.width * candidate.map.height;
+std::vector<std::vector<const Cell*>> startSymmetries(std::vector<SolveResult*>& results, SymmetryTable& symmetryTable) {
+    int cells = symmetryTable.cells;
+    std::vector<std::vector<const Cell*>> symmetries(cells);
+    for (int res = 0; res < results.size(); res++) {
+        for (int cell = 0; cell < cells; cell++) {
+            for (int end = 0; end < cells; end++) {
+                if (results[res]->pairCounts[cell * cells + end] != 0 && symmetries[cell].empty()) {
+                    std::vector<int> transforms = symmetryTable.transformsOf(cell);
+                    for (int sym = 0; sym < transforms.size(); sym++)
+                        symmetries[cell].push_back(symmetryTable.permutation(transforms[sym]));
+                }
+            }
+        }
+    }
+    return symmetries;
 }
 
-bool connected(Candidate& candidate, std::vector<Pos>& deltaDirections) {
-    Pos startPos = Pos(0, 0);
-    bool found = false;
-    for (int y = 0; y < candidate.map.height && !found; y++)
-        for (int x = 0; x < candidate.map.width && !found; x++)
-            if (!candidate.map[y][x]) {
-                startPos = Pos(x, y);
-                found = true;
+std::vector<uint64_t> expandPairCounts(std::vector<SolveResult*>& results, std::vector<std::vector<const Cell*>>& symmetries, int cells) {
+    std::vector<uint64_t> pairCounts(cells * cells, 0);
+    for (int res = 0; res < results.size(); res++) {
+        for (int start = 0; start < cells; start++) {
+            for (int end = 0; end < cells; end++) {
+                uint64_t count = results[res]->pairCounts[start * cells + end];
+                if (count == 0)
+                    continue;
+                for (int sym = 0; sym < symmetries[start].size(); sym++) {
+                    int symStart = symmetries[start][sym][start];
+                    int symEnd = symmetries[start][sym][end];
+                    pairCounts[symStart * cells + symEnd] += count;
+                }
             }
+        }
+    }
+    return pairCounts;
+}
+
+void saveResume(const std::string& filepath, int size, std::deque<Candidate>& unfinished, std::vector<uint64_t>& pairCounts) {
+    std::ofstream file(filepath);
+    file << size << '\n';
+    for (int i = 0; i < pairCounts.size(); i++)
+        file << pairCounts[i] << (i + 1 == pairCounts.size() ? '\n' : ' ');
+    for (int i = 0; i < unfinished.size(); i++)
+        for (int p = 0; p < unfinished[i].pathIndex; p++)
+            file << (int)unfinished[i].path[p] << (p + 1 == unfinished[i].pathIndex ? '\n' : ' ');
+    file.close();
+}
 
-    Bitmap toCheck(candidate.map);
-    int numTiles = floodFill(toCheck, false, startPos, deltaDirections);
-    return numTiles == (candidate.map.width * candidate.map.height - candidate.pathIndex); // checks if the num of connected tiles is the num of the remaining tiles
+bool loadResume(const std::string& filepath, int size, std::deque<Candidate>& startingPoses, std::vector<uint64_t>& pairCounts) {
+    std::ifstream file(filepath);
+    std::string line;
+    if (!std::getline(file, line) || line != std::to_string(size) || !std::getline(file, line))
+        return false;
+    std::istringstream countLine(line);
+    for (int i = 0; i < pairCounts.size(); i++)
+        if (!(countLine >> pairCounts[i]))
+            return false;
+
+    startingPoses.clear();
+    std::vector<Cell> path;
+    while (std::getline(file, line)) {
+        std::istringstream pathLine(line);
+        path.clear();
+        int cell;
+        while (pathLine >> cell) {
+            if (cell < 0 || cell >= size * size)
+                return false;
+            path.push_back(cell);
+        }
+        if (!path.empty())
+            startingPoses.push_back(prefixCandidate(size, size, path.data(), path.size()));
+    }
+    return true;
 }
 
-int floodFill(Bitmap& toFill, bool valToFill, Pos currPos, std::vector<Pos>& deltaDirections) {
-    if (currPos.x < 0 || currPos.x >= toFill.width || currPos.y < 0 || currPos.y >= toFill.height)
-        return 0;
-    if (toFill[currPos.y][currPos.x] != valToFill)
-        return 0;
-    
-    toFill[currPos.y][currPos.x] = !valToFill;
-    int sum = 1; // 1 is for this tile
-    for (int i = 0; i < deltaDirections.size(); i++)
-        sum += floodFill(toFill, valToFill, currPos + deltaDirections[i], deltaDirections);
-    return sum;
+void writeCountTable(std::ostream& os, std::vector<std::vector<uint64_t>>& counts) {
+    int maxDigits = 0;
+    for (int y = 0; y < counts.size(); y++)
+        for (int x = 0; x < counts[y].size(); x++)
+            maxDigits = std::max(std::to_string(counts[y][x]).size(), (size_t)maxDigits);
+
+    for (int y = 0; y < counts.size(); y++) {
+        for (int x = 0; x < counts[y].size(); x++) {
+            os << std::string(maxDigits - std::to_string(counts[y][x]).size(), '0');
+            os << counts[y][x] << ' ';
+        }
+        os << '\n';
+    }
 }
 
-Candidate applyToEntirePath(Candidate candidate, std::function<Pos(Pos, int, Candidate&)> func) {
-    for (int i = 0; i < candidate.path.size() && i < candidate.pathIndex; i++)
-        candidate.path[i] = func(candidate.path[i], i, candidate);
-    return candidate;
-}
\ No newline at end of file
+template<typename GetPath>
+void renderPaths(int size, size_t count, GetPath getPath, const RenderOptions& options, bool atlas) {
+    auto renderStart = std::chrono::high_resolution_clock::now();
+    PathRenderer renderer(size, size, options);
+    int numThreads = MULTITHREAD ? std::max((int)std::thread::hardware_concurrency(), 1) : 1;
+    std::string name = std::to_string(size) + "x" + std::to_string(size);
+
+    std::filesystem::create_directory("render");
+    bool ok = atlas ? renderer.renderAtlas(count, getPath, "render/atlas" + name + ".png", numThreads)
+                    : renderer.renderFiles(count, getPath, "render/render" + name + "_", numThreads);
+    if (!ok)
+        std::cerr << "Could not write all images to render/!" << std::endl;
+
+    std::chrono::duration<double, std::milli> duration = std::chrono::high_resolution_clock::now() - renderStart;
+    std::cout << "rendered: " << count << (atlas ? " paths into one atlas" : " images") << " in " << duration.count() << "ms" << std::endl;
+}
@@ -1,128 +1,244 @@
 import os
 import sys
-import math
 import time
+import ctypes
 import multiprocessing
+from array import array
 
 SIZE: int = int(sys.argv[1])
+# --native: solves with the c++ engine (c++/library.cpp built as a shared library) instead of the Walker
+# --sample <n>: with --native also writes n random walks (sampled by the c++ backbite chain) to out/<SIZE>_samples.txt
+# --count: only counts the solutions, nothing is sent back from the processes but the count and no file is written
+NATIVE: bool = "--native" in sys.argv[2:]
+SAMPLES: int = int(sys.argv[sys.argv.index("--sample") + 1]) if "--sample" in sys.argv[2:] else 0
+COUNT_ONLY: bool = "--count" in sys.argv[2:]
 
-found: set = set()
+CHUNK_SIZE: int = 4096 # solutions per message from a process (and per batch from the c++ library)
 
 class Walker:
-    def __init__(self, size: int, start: tuple) -> None:
+    """Walks every path from start that visits every cell, the cells are indices (y * size + x)"""
+
+    def __init__(self, size: int, start: int) -> None:
         self.size = size
+        self.full = (1 << (size * size)) - 1
 
         self.neighbors = self.preCalcNeighbors()
+        # the cells that aren't in the first or the last column, so shifting a row by one doesn't wrap into the next row
+        first_column = sum(1 << (y * size) for y in range(size))
+        self.not_first_column = self.full & ~first_column
+        self.not_last_column = self.full & ~(first_column << (size - 1))
 
         self.path = [start]
-        self.path_set = set(self.path)
+        self.occupied = 1 << start # one bit per cell of the path, updated with every step instead of building a set
 
         self.possibilities = []
 
-        self.found = set()
-
-    def getNeighbors(self, cords) -> list:
-        x, y = cords
-        size = self.size
+    def getNeighbors(self, cell: int) -> list:
+        x, y = cell % self.size, cell // self.size
         possible = ((x, y - 1), (x + 1, y), (x, y + 1), (x - 1, y))
-        return [pair for pair in possible if 0 <= pair[0] < size and 0 <= pair[1] < size]
-
-    def preCalcNeighbors(self) -> dict:
-        neighbor_dict = {}
-        for x in range(self.size):
-            for y in range(self.size):
-                neighbor_dict[(x, y)] = self.getNeighbors((x, y))
-        return neighbor_dict
-
-    def choose_neighbor(self, cords) -> tuple:
-        path_set = set(self.path)
-        neighbor_options = [neighbor for neighbor in self.neighbors[cords] if neighbor not in path_set]
-        return (neighbor_options[0], neighbor_options[1:]) if neighbor_options else None
-    
-    def choose_neighbor(self, cords) -> tuple:
-        path_set = set(self.path)
-        neighbor_options = [neighbor for neighbor in self.neighbors[cords] if neighbor not in path_set]
+        return [ny * self.size + nx for nx, ny in possible if 0 <= nx < self.size and 0 <= ny < self.size]
+
+    def preCalcNeighbors(self) -> list:
+        return [self.getNeighbors(cell) for cell in range(self.size * self.size)]
+
+    def connected(self, occupied: int) -> bool:
+        """If the free cells are still one area (like connected() of the c++ version), otherwise they can't all be walked"""
+        free = self.full & ~occupied
+        reached = free & -free
+        while True:
+            grown = (reached | ((reached << 1) & self.not_first_column) | ((reached >> 1) & self.not_last_column)
+                     | (reached << self.size) | (reached >> self.size)) & free
+            if grown == reached:
+                return reached == free
+            reached = grown
+
+    def choose_neighbor(self, cell: int) -> tuple:
+        neighbor_options = [neighbor for neighbor in self.neighbors[cell]
+                            if not self.occupied >> neighbor & 1 and self.connected(self.occupied | 1 << neighbor)]
         if not neighbor_options:
             return None
-        
+
         return neighbor_options[0], neighbor_options[1:]
 
-    
-    def generate(self) -> int:
+    def generate(self):
+        """Yields every solution (as a tuple of cells) the moment it is found"""
         end_len = self.size * self.size
         while True:
             neighbors = self.choose_neighbor(self.path[-1])
             if not neighbors:
                 if len(self.path) == end_len:
-                    self.found.add(tuple(self.path))
+                    yield tuple(self.path)
 
                 while self.possibilities and not self.possibilities[-1]:
-                    self.path.pop()
+                    self.occupied ^= 1 << self.path.pop()
                     self.possibilities.pop()
 
                 if not self.possibilities:
-                    print(f"{self.path[0]} done")
-                    return self.found
-                
+                    return
+
                 new = self.possibilities[-1].pop()
-                self.path.pop()
+                self.occupied ^= 1 << self.path.pop()
                 self.path.append(new)
+                self.occupied |= 1 << new
                 continue
 
             new, other = neighbors
             self.path.append(new)
+            self.occupied |= 1 << new
             self.possibilities.append(other)
 
-def process_start_point(start_point, shared_dict):
-    shared_dict[start_point] = Walker(SIZE, start_point).generate()
+def transforms(size: int) -> list:
+    """The cell every cell moves to with each of the 8 symmetries of the field (the identity first), numbered like the
+    SymmetryTable of the c++ engine: transform & 4 swaps x and y, then & 1 mirrors x and & 2 mirrors y"""
+    tables = []
+    for transform in range(8):
+        table = []
+        for cell in range(size * size):
+            x, y = cell % size, cell // size
+            if transform & 4:
+                x, y = y, x
+            if transform & 1:
+                x = size - x - 1
+            if transform & 2:
+                y = size - y - 1
+            table.append(y * size + x)
+        tables.append(table)
+    return tables
+
+def canonical_starts(size: int) -> dict:
+    """The starts no symmetry moves to a smaller cell, each with one symmetry for every cell it moves the start to
+    (the solutions from all of them with those symmetries are every solution exactly once)"""
+    starts = {}
+    tables = transforms(size)
+    for start in range(size * size):
+        x, y = start % size, start // size
+        if (x + y) % 2 == 1 and size % 2 == 1: # no solution starts there
+            continue
+        images = {}
+        for table in tables:
+            images.setdefault(table[start], table)
+        if min(images) == start:
+            starts[start] = list(images.values())
+    return starts
+
+def process_start_point(start: int, queue, keep_paths: bool) -> None:
+    """Streams the solutions from start back in chunks of 16 bit cells as they are found, and the count at the end"""
+    count = 0
+    chunk = array('H')
+    for path in Walker(SIZE, start).generate():
+        count += 1
+        if keep_paths:
+            chunk.extend(path)
+            if len(chunk) >= CHUNK_SIZE * SIZE * SIZE:
+                queue.put(("paths", start, chunk.tobytes()))
+                chunk = array('H')
+    if chunk:
+        queue.put(("paths", start, chunk.tobytes()))
+    queue.put(("done", start, count))
+
+# the callback of sawEnumerateBatches: (paths, count, user data) -> 0 to stop
+SAW_BATCH_CALLBACK = ctypes.CFUNCTYPE(ctypes.c_int, ctypes.POINTER(ctypes.c_uint16), ctypes.c_uint64, ctypes.c_void_p)
+
+def load_native():
+    """The c++ engine through its C interface (c++/include/sawLibrary.h), None if the library isn't built"""
+    folder = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "c++")
+    for name in ("libsaw.so", "libsaw.dylib", "saw.dll"):
+        path = os.path.join(folder, name)
+        if not os.path.exists(path):
+            continue
+        lib = ctypes.CDLL(path)
+        lib.sawCount.argtypes = [ctypes.c_int, ctypes.c_int, ctypes.c_int, ctypes.c_int]
+        lib.sawCount.restype = ctypes.c_int64
+        lib.sawEnumerate.argtypes = [ctypes.c_int, ctypes.c_int, ctypes.c_int, ctypes.c_int, ctypes.POINTER(ctypes.c_uint16), ctypes.c_uint64]
+        lib.sawEnumerate.restype = ctypes.c_int64
+        lib.sawEnumerateBatches.argtypes = [ctypes.c_int, ctypes.c_int, ctypes.c_int, ctypes.c_int, ctypes.c_uint64, SAW_BATCH_CALLBACK, ctypes.c_void_p]
+        lib.sawEnumerateBatches.restype = ctypes.c_int64
+        lib.sawSample.argtypes = [ctypes.c_int, ctypes.c_int, ctypes.c_uint64, ctypes.c_uint64, ctypes.c_uint64, ctypes.POINTER(ctypes.c_uint16), ctypes.c_uint64]
+        lib.sawSample.restype = ctypes.c_int64
+        return lib
+    return None
+
+def native_paths(buffer, count: int, size: int) -> list:
+    """The (x, y) tuples of the paths the library wrote into buffer (size * size cell indices each)"""
+    cells = size * size
+    return [tuple((cell % size, cell // size) for cell in buffer[i * cells:(i + 1) * cells]) for i in range(count)]
+
+def native_write_solutions(lib, size: int, file) -> int:
+    """Writes every solution to file batch by batch while the library searches (one search, only a batch is in memory at a time)"""
+    cells = size * size
+    cords = [(cell % size, cell // size) for cell in range(cells)]
+
+    def write_batch(paths, count: int, user_data) -> int:
+        values = array('H', ctypes.string_at(paths, count * cells * 2))
+        for i in range(0, len(values), cells):
+            file.write(f"{tuple(cords[cell] for cell in values[i:i + cells])}\n")
+        return 1
+
+    return lib.sawEnumerateBatches(size, size, -1, 0, CHUNK_SIZE, SAW_BATCH_CALLBACK(write_batch), None)
+
+def native_samples(lib, size: int, count: int, seed: int = 0) -> list:
+    buffer = (ctypes.c_uint16 * (count * size * size))()
+    written = lib.sawSample(size, size, seed, 0, 0, buffer, count)
+    return native_paths(buffer, written, size)
 
 if __name__ == '__main__':
     start = time.time()
 
-    processes = []
-    manager = multiprocessing.Manager()
-    return_dict = manager.dict()
-
-    for x in range(math.ceil(SIZE/2)):
-        for y in range(x + 1):
-            if (x+y) % 2 == 1 and SIZE % 2 == 1:
-                continue
-            p = multiprocessing.Process(target=process_start_point, args=((x,y), return_dict))
-            p.start()
-            processes.append(p)
-    
-    middle_x, middle_y = math.ceil(SIZE/2)-1, math.ceil(SIZE/2)-1
-    p = multiprocessing.Process(target=process_start_point, args=((middle_x,middle_y), return_dict))
-    p.start()
-    processes.append(p)
-    
-    print(f"Started {len(processes)} processes on {multiprocessing.cpu_count()} cores")
-
-    for p in processes:
-        p.join()
-
-    for val in return_dict.values():
-        found.update(val)
-
-    for val in return_dict.values():
-        for solution in val:
-            found.add(tuple([(y, x) for x, y in solution]))
-
-    for solution in set(found):
-        found.add(tuple([(SIZE - x - 1, y) for x, y in solution]))
-        found.add(tuple([(x, SIZE - y - 1) for x, y in solution]))
-        found.add(tuple([(SIZE - x - 1, SIZE - y - 1) for x, y in solution]))
+    native = load_native() if NATIVE else None
+    if NATIVE and native is None:
+        print("The c++ library isn't built (see c++/library.cpp)")
+        sys.exit(1)
 
-    print(f"Found {len(found)} solutions")
-    print(f"Calculations took {time.time() - start:.5f} seconds")
-
-    start = time.time()
-    
     if not os.path.exists("out"):
         os.makedirs("out")
+    file = None if COUNT_ONLY else open(f'out/{SIZE}.txt', 'w')
+    num_solutions = 0
+
+    if native:
+        if COUNT_ONLY:
+            num_solutions = native.sawCount(SIZE, SIZE, -1, 0)
+        else:
+            num_solutions = native_write_solutions(native, SIZE, file)
+    else:
+        # the solutions are written while the processes still search, with the symmetries of their start
+        cords = [(cell % SIZE, cell // SIZE) for cell in range(SIZE * SIZE)]
+        starts = canonical_starts(SIZE)
+        queue = multiprocessing.Queue()
+        processes = []
+        for start_point in starts:
+            p = multiprocessing.Process(target=process_start_point, args=(start_point, queue, not COUNT_ONLY))
+            p.start()
+            processes.append(p)
 
-    with open(f'out/{SIZE}.txt', 'w') as file:
-        for cords in found:
-            file.write(f"{cords}\n")
-
-    print(f"Saved to file in {time.time() - start:.5f} seconds")
\ No newline at end of file
+        print(f"Started {len(processes)} processes on {multiprocessing.cpu_count()} cores")
+
+        running = len(processes)
+        while running:
+            kind, start_point, data = queue.get()
+            if kind == "paths":
+                paths = array('H')
+                paths.frombytes(data)
+                for i in range(0, len(paths), SIZE * SIZE):
+                    path = paths[i:i + SIZE * SIZE]
+                    for table in starts[start_point]:
+                        file.write(f"{tuple(cords[table[cell]] for cell in path)}\n")
+            else:
+                num_solutions += data * len(starts[start_point])
+                print(f"{cords[start_point]} done")
+                running -= 1
+
+        for p in processes:
+            p.join()
+
+    if file:
+        file.close()
+
+    print(f"Found {num_solutions} solutions")
+    print(f"Calculations took {time.time() - start:.5f} seconds" + ("" if COUNT_ONLY else " (with saving to file)"))
+
+    if native and SAMPLES > 0:
+        start = time.time()
+        with open(f'out/{SIZE}_samples.txt', 'w') as file:
+            for cords in native_samples(native, SIZE, SAMPLES):
+                file.write(f"{cords}\n")
+        print(f"Saved samples to file in {time.time() - start:.5f} seconds")
\ No newline at end of file